@@ -0,0 +1,37 @@
+# cx_embed_json(<target> <file.json> [<namespace>])
+#
+# Parse a JSON file at build time, with the host tool cx_embed_json, into a
+# header of constexpr storage that <target> can include as "<name>_json.h"
+# (where <name> is the file name without extension). The header declares, in
+# <namespace> (by default <name>, made into an identifier):
+#
+#   JSON::value objects[]   the parsed values
+#   char strings[]          the string storage
+#   json                    a JSON::value_proxy over them
+#
+# The header is regenerated when the JSON file changes.
+
+function(cx_embed_json target file)
+  get_filename_component(file_path "${file}" ABSOLUTE)
+  get_filename_component(name "${file}" NAME_WE)
+  string(MAKE_C_IDENTIFIER "${name}" identifier)
+  if(ARGC GREATER 2)
+    set(ns "${ARGV2}")
+  else()
+    set(ns "${identifier}")
+  endif()
+
+  set(out_dir "${CMAKE_CURRENT_BINARY_DIR}/cx_embed_json/${target}")
+  set(header "${out_dir}/${identifier}_json.h")
+  add_custom_command(
+    OUTPUT "${header}"
+    COMMAND "${CMAKE_COMMAND}" -E make_directory "${out_dir}"
+    COMMAND cx_embed_json "${file_path}" "${header}" "${ns}"
+    DEPENDS cx_embed_json "${file_path}"
+    COMMENT "Embedding ${file} as ${ns}::json"
+    VERBATIM)
+
+  add_custom_target(${target}_${identifier}_json DEPENDS "${header}")
+  add_dependencies(${target} ${target}_${identifier}_json)
+  target_include_directories(${target} PRIVATE "${out_dir}")
+endfunction()
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "cx_pair.h"
+
+#include <functional>
+#include <iterator>
+
+namespace cx
+{
+  template <class ForwardIt, class T, class Compare>
+  constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last,
+                                  const T& value, Compare comp)
+  {
+    auto count = std::distance(first, last);
+    while (count > 0) {
+      const auto step = count / 2;
+      const auto it = std::next(first, step);
+      if (comp(*it, value)) {
+        first = std::next(it);
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return first;
+  }
+
+  template <class ForwardIt, class T>
+  constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& value)
+  {
+    return cx::lower_bound(first, last, value, std::less<>{});
+  }
+
+  template <class ForwardIt, class T, class Compare>
+  constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last,
+                                  const T& value, Compare comp)
+  {
+    auto count = std::distance(first, last);
+    while (count > 0) {
+      const auto step = count / 2;
+      const auto it = std::next(first, step);
+      if (!comp(value, *it)) {
+        first = std::next(it);
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return first;
+  }
+
+  template <class ForwardIt, class T>
+  constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& value)
+  {
+    return cx::upper_bound(first, last, value, std::less<>{});
+  }
+
+  template <class ForwardIt, class T, class Compare>
+  constexpr cx::pair<ForwardIt, ForwardIt> equal_range(ForwardIt first, ForwardIt last,
+                                                       const T& value, Compare comp)
+  {
+    return cx::pair<ForwardIt, ForwardIt>{cx::lower_bound(first, last, value, comp),
+                                          cx::upper_bound(first, last, value, comp)};
+  }
+
+  template <class ForwardIt, class T>
+  constexpr cx::pair<ForwardIt, ForwardIt> equal_range(ForwardIt first, ForwardIt last,
+                                                       const T& value)
+  {
+    return cx::equal_range(first, last, value, std::less<>{});
+  }
+
+  template <class ForwardIt, class T, class Compare>
+  constexpr bool binary_search(ForwardIt first, ForwardIt last,
+                               const T& value, Compare comp)
+  {
+    first = cx::lower_bound(first, last, value, comp);
+    return first != last && !comp(value, *first);
+  }
+
+  template <class ForwardIt, class T>
+  constexpr bool binary_search(ForwardIt first, ForwardIt last, const T& value)
+  {
+    return cx::binary_search(first, last, value, std::less<>{});
+  }
+
+  // Branchless binary search: the range always halves, whatever the
+  // comparison says, so the loop runs a fixed number of times for a given
+  // size, and the comparison result only selects the next base (which
+  // compilers turn into a conditional move rather than a mispredictable
+  // branch).
+  template <class RandomIt, class T, class Compare>
+  constexpr RandomIt branchless_lower_bound(RandomIt first, RandomIt last,
+                                            const T& value, Compare comp)
+  {
+    auto n = last - first;
+    if (n == 0) return first;
+    while (n > 1) {
+      const auto half = n / 2;
+      first = comp(first[half], value) ? first + half : first;
+      n -= half;
+    }
+    return comp(*first, value) ? first + 1 : first;
+  }
+
+  template <class RandomIt, class T>
+  constexpr RandomIt branchless_lower_bound(RandomIt first, RandomIt last,
+                                            const T& value)
+  {
+    return cx::branchless_lower_bound(first, last, value, std::less<>{});
+  }
+
+  template <class RandomIt, class T, class Compare>
+  constexpr RandomIt branchless_upper_bound(RandomIt first, RandomIt last,
+                                            const T& value, Compare comp)
+  {
+    auto n = last - first;
+    if (n == 0) return first;
+    while (n > 1) {
+      const auto half = n / 2;
+      first = !comp(value, first[half]) ? first + half : first;
+      n -= half;
+    }
+    return comp(value, *first) ? first : first + 1;
+  }
+
+  template <class RandomIt, class T>
+  constexpr RandomIt branchless_upper_bound(RandomIt first, RandomIt last,
+                                            const T& value)
+  {
+    return cx::branchless_upper_bound(first, last, value, std::less<>{});
+  }
+}
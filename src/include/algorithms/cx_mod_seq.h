@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 namespace cx
 {
   template <class InputIt, class OutputIt>
@@ -66,6 +68,26 @@ namespace cx
     return d_last;
   }
 
+  template <class InputIt, class OutputIt, class UnaryOperation>
+  constexpr OutputIt transform(InputIt first1, InputIt last1, OutputIt d_first,
+                               UnaryOperation unary_op)
+  {
+    while (first1 != last1) {
+      *d_first++ = unary_op(*first1++);
+    }
+    return d_first;
+  }
+
+  template <class InputIt1, class InputIt2, class OutputIt, class BinaryOperation>
+  constexpr OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2,
+                               OutputIt d_first, BinaryOperation binary_op)
+  {
+    while (first1 != last1) {
+      *d_first++ = binary_op(*first1++, *first2++);
+    }
+    return d_first;
+  }
+
   template <class ForwardIt, class T>
   constexpr void fill(ForwardIt first, ForwardIt last, const T& value)
   {
@@ -83,4 +105,31 @@ namespace cx
     return first;
   }
 
+  template <class ForwardIt1, class ForwardIt2>
+  constexpr void iter_swap(ForwardIt1 a, ForwardIt2 b)
+  {
+    // std::swap isn't constexpr until C++20
+    auto tmp = std::move(*a);
+    *a = std::move(*b);
+    *b = std::move(tmp);
+  }
+
+  template <class ForwardIt>
+  constexpr ForwardIt rotate(ForwardIt first, ForwardIt n_first, ForwardIt last)
+  {
+    if (first == n_first) return last;
+    if (n_first == last) return first;
+
+    auto read = n_first;
+    auto write = first;
+    auto next_read = first;
+    while (read != last) {
+      if (write == next_read) next_read = read;
+      cx::iter_swap(write++, read++);
+    }
+    // rotate the remaining sequence into place
+    cx::rotate(write, next_read, last);
+    return write;
+  }
+
 }
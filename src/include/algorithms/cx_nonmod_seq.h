@@ -1,7 +1,11 @@
 #pragma once
 
+#include "cx_config.h"
 #include "cx_pair.h"
+#include "cx_searchers.h"
+#include "cx_simd.h"
 
+#include <cstddef>
 #include <iterator>
 
 namespace cx
@@ -24,6 +28,13 @@ namespace cx
   template <class InputIt, class T>
   constexpr InputIt find(InputIt first, InputIt last, const T& value)
   {
+    if constexpr (detail::fast_find_v<InputIt, T>) {
+      if (!cx::is_constant_evaluated()) {
+        const auto n = static_cast<std::size_t>(last - first);
+        return first + static_cast<std::ptrdiff_t>(detail::find_byte(
+                   detail::to_pointer(first), n, static_cast<unsigned char>(value)));
+      }
+    }
     for (; first != last; ++first) {
       if (*first == value) {
         return first;
@@ -91,6 +102,14 @@ namespace cx
   constexpr cx::pair<InputIt1, InputIt2> mismatch(InputIt1 first1, InputIt1 last1,
                                                   InputIt2 first2, InputIt2 last2)
   {
+    if constexpr (detail::fast_compare_v<InputIt1, InputIt2>) {
+      if (!cx::is_constant_evaluated()) {
+        const auto i = static_cast<std::ptrdiff_t>(detail::fast_mismatch(
+            first1, static_cast<std::size_t>(last1 - first1),
+            first2, static_cast<std::size_t>(last2 - first2)));
+        return cx::pair<InputIt1, InputIt2>{first1 + i, first2 + i};
+      }
+    }
     while (first1 != last1 && first2 != last2 && *first1 == *first2) {
       ++first1, ++first2;
     }
@@ -101,6 +120,14 @@ namespace cx
   constexpr bool equal(InputIt1 first1, InputIt1 last1,
                        InputIt2 first2, InputIt2 last2)
   {
+    if constexpr (detail::fast_compare_v<InputIt1, InputIt2>) {
+      if (!cx::is_constant_evaluated()) {
+        // different lengths are rejected without looking at the contents
+        const auto n = static_cast<std::size_t>(last1 - first1);
+        return n == static_cast<std::size_t>(last2 - first2)
+          && detail::fast_mismatch(first1, n, first2, n) == n;
+      }
+    }
     while (first1 != last1 && first2 != last2 && *first1 == *first2) {
       ++first1, ++first2;
     }
@@ -132,35 +159,34 @@ namespace cx
     return first;
   }
 
+  template <class ForwardIt, class Searcher>
+  constexpr ForwardIt search(ForwardIt first, ForwardIt last,
+                             const Searcher& searcher)
+  {
+    return searcher(first, last).first;
+  }
+
+  // Searching for a pattern of integers (i.e. chars) in a random access range
+  // uses a two-way searcher, which is linear rather than O(n*m).
   template <class ForwardIt1, class ForwardIt2>
   constexpr ForwardIt1 search(ForwardIt1 first, ForwardIt1 last,
                               ForwardIt2 s_first, ForwardIt2 s_last)
   {
-    for (; ; ++first) {
-      ForwardIt1 it = first;
-      for (ForwardIt2 s_it = s_first; ; ++it, ++s_it) {
-        if (s_it == s_last) {
-          return first;
-        }
-        if (it == last) {
-          return last;
-        }
-        if (!(*it == *s_it)) {
-          break;
-        }
-      }
+    if constexpr (detail::two_way_searchable_v<ForwardIt1, ForwardIt2>) {
+      return cx::search(first, last, cx::two_way_searcher<ForwardIt2>(s_first, s_last));
+    } else {
+      return cx::search(first, last, cx::default_searcher<ForwardIt2>(s_first, s_last));
     }
   }
 
-  template <class ForwardIt1, class ForwardIt2>
-  constexpr ForwardIt1 find_end(ForwardIt1 first, ForwardIt1 last,
-                                ForwardIt2 s_first, ForwardIt2 s_last)
+  // the last match for a searcher (which must not match an empty pattern)
+  template <class ForwardIt, class Searcher>
+  constexpr ForwardIt find_end(ForwardIt first, ForwardIt last,
+                               const Searcher& searcher)
   {
-    if (s_first == s_last)
-      return last;
-    ForwardIt1 result = last;
-    while (1) {
-      ForwardIt1 new_result = cx::search(first, last, s_first, s_last);
+    ForwardIt result = last;
+    while (true) {
+      ForwardIt new_result = searcher(first, last).first;
       if (new_result == last) {
         return result;
       } else {
@@ -169,7 +195,19 @@ namespace cx
         ++first;
       }
     }
-    return result;
+  }
+
+  template <class ForwardIt1, class ForwardIt2>
+  constexpr ForwardIt1 find_end(ForwardIt1 first, ForwardIt1 last,
+                                ForwardIt2 s_first, ForwardIt2 s_last)
+  {
+    if (s_first == s_last)
+      return last;
+    if constexpr (detail::two_way_searchable_v<ForwardIt1, ForwardIt2>) {
+      return cx::find_end(first, last, cx::two_way_searcher<ForwardIt2>(s_first, s_last));
+    } else {
+      return cx::find_end(first, last, cx::default_searcher<ForwardIt2>(s_first, s_last));
+    }
   }
 
   template <class InputIt, class ForwardIt>
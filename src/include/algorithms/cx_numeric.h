@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace cx
+{
+  template <class InputIt, class T, class BinaryOperation>
+  constexpr T accumulate(InputIt first, InputIt last, T init, BinaryOperation op)
+  {
+    for (; first != last; ++first) {
+      init = op(std::move(init), *first);
+    }
+    return init;
+  }
+
+  template <class InputIt, class T>
+  constexpr T accumulate(InputIt first, InputIt last, T init)
+  {
+    return cx::accumulate(first, last, std::move(init), std::plus<>{});
+  }
+
+  // like accumulate, but op must be associative and commutative, which lets
+  // the parallel version combine partial results in any order
+  template <class InputIt, class T, class BinaryOperation>
+  constexpr T reduce(InputIt first, InputIt last, T init, BinaryOperation op)
+  {
+    return cx::accumulate(first, last, std::move(init), op);
+  }
+
+  template <class InputIt, class T>
+  constexpr T reduce(InputIt first, InputIt last, T init)
+  {
+    return cx::reduce(first, last, std::move(init), std::plus<>{});
+  }
+
+  template <class InputIt>
+  constexpr typename std::iterator_traits<InputIt>::value_type
+  reduce(InputIt first, InputIt last)
+  {
+    return cx::reduce(first, last,
+                      typename std::iterator_traits<InputIt>::value_type{});
+  }
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "cx_pair.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Searchers for cx::search(first, last, searcher), as with std::search: a
+// searcher is built once from the pattern, and called with the range to
+// search, returning the matching subrange (or an empty range at last).
+
+namespace cx
+{
+  template <class ForwardIt>
+  class default_searcher
+  {
+  public:
+    constexpr default_searcher(ForwardIt pat_first, ForwardIt pat_last)
+      : m_first(pat_first), m_last(pat_last)
+    {}
+
+    template <class ForwardIt2>
+    constexpr cx::pair<ForwardIt2, ForwardIt2> operator()(ForwardIt2 first,
+                                                          ForwardIt2 last) const
+    {
+      for (; ; ++first) {
+        ForwardIt2 it = first;
+        for (ForwardIt s_it = m_first; ; ++it, ++s_it) {
+          if (s_it == m_last) return cx::pair<ForwardIt2, ForwardIt2>{first, it};
+          if (it == last) return cx::pair<ForwardIt2, ForwardIt2>{last, last};
+          if (!(*it == *s_it)) break;
+        }
+      }
+    }
+
+  private:
+    ForwardIt m_first;
+    ForwardIt m_last;
+  };
+
+  // Boyer-Moore-Horspool: compare the last character of the window first, and
+  // on a mismatch, shift the window by how far that character is from the end
+  // of the pattern - usually the pattern length. Sublinear on typical text,
+  // but O(n*m) in the worst case. The skip table is indexed by byte, so this
+  // is for patterns of chars (or other byte-sized values).
+  template <class RandomIt>
+  class boyer_moore_horspool_searcher
+  {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(sizeof(value_type) == 1,
+                  "boyer_moore_horspool_searcher needs byte-sized values");
+
+  public:
+    constexpr boyer_moore_horspool_searcher(RandomIt pat_first, RandomIt pat_last)
+      : m_first(pat_first), m_size(pat_last - pat_first)
+    {
+      for (auto& s : m_skip) s = m_size;
+      for (std::ptrdiff_t i = 0; i < m_size - 1; ++i) {
+        m_skip[index(m_first[i])] = m_size - 1 - i;
+      }
+    }
+
+    template <class RandomIt2>
+    constexpr cx::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first,
+                                                        RandomIt2 last) const
+    {
+      if (m_size == 0) return cx::pair<RandomIt2, RandomIt2>{first, first};
+      const auto m = m_size;
+      const auto n = last - first;
+      for (std::ptrdiff_t j = 0; j <= n - m;) {
+        const auto c = first[j + m - 1];
+        if (c == m_first[m - 1]) {
+          std::ptrdiff_t i = 0;
+          while (i < m - 1 && first[j + i] == m_first[i]) ++i;
+          if (i == m - 1) {
+            return cx::pair<RandomIt2, RandomIt2>{first + j, first + j + m};
+          }
+        }
+        j += m_skip[index(c)];
+      }
+      return cx::pair<RandomIt2, RandomIt2>{last, last};
+    }
+
+  private:
+    template <typename C>
+    static constexpr std::size_t index(C c)
+    {
+      return static_cast<unsigned char>(c);
+    }
+
+    RandomIt m_first;
+    std::ptrdiff_t m_size;
+    std::ptrdiff_t m_skip[256]{};
+  };
+
+  // Two-way (Crochemore-Perrin): split the pattern at a critical
+  // factorization, match the right part forwards and then the left part
+  // backwards, and use the pattern's period to shift safely. Linear in the
+  // worst case, with constant extra space - so it suits constant evaluation,
+  // where the loop counts add up. It needs values ordered by <.
+  template <class RandomIt>
+  class two_way_searcher
+  {
+  public:
+    constexpr two_way_searcher(RandomIt pat_first, RandomIt pat_last)
+      : m_first(pat_first), m_size(pat_last - pat_first)
+    {
+      if (m_size == 0) return;
+      std::ptrdiff_t p = 1;
+      std::ptrdiff_t q = 1;
+      const auto i = maximal_suffix(false, p);
+      const auto j = maximal_suffix(true, q);
+      if (i > j) {
+        m_ell = i;
+        m_period = p;
+      } else {
+        m_ell = j;
+        m_period = q;
+      }
+
+      // is the left part repeated at the period? then the pattern is
+      // periodic, and we can remember how much of it already matched
+      const auto l = m_ell + 1;
+      const auto r = m_size - l;
+      m_periodic = m_period <= r;
+      for (std::ptrdiff_t k = 0; m_periodic && k < l; ++k) {
+        m_periodic = m_first[k] == m_first[k + m_period];
+      }
+      if (!m_periodic) {
+        m_period = (l > r ? l : r) + 1;
+      }
+    }
+
+    template <class RandomIt2>
+    constexpr cx::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first,
+                                                        RandomIt2 last) const
+    {
+      const auto m = m_size;
+      if (m == 0) return cx::pair<RandomIt2, RandomIt2>{first, first};
+      const auto n = last - first;
+      const auto x = m_first;
+      std::ptrdiff_t memory = -1;
+      for (std::ptrdiff_t j = 0; j <= n - m;) {
+        const auto y = first + j;
+        auto i = (m_ell > memory ? m_ell : memory) + 1;
+        while (i < m && x[i] == y[i]) ++i;
+        if (i < m) {
+          j += i - m_ell;
+          memory = -1;
+          continue;
+        }
+        const auto stop = m_periodic ? memory : -1;
+        i = m_ell;
+        while (i > stop && x[i] == y[i]) --i;
+        if (i <= stop) return cx::pair<RandomIt2, RandomIt2>{y, y + m};
+        j += m_period;
+        if (m_periodic) memory = m - m_period - 1;
+      }
+      return cx::pair<RandomIt2, RandomIt2>{last, last};
+    }
+
+  private:
+    // the start (less one) of the maximal suffix of the pattern for < (or,
+    // reversed, for >), and its period
+    constexpr std::ptrdiff_t maximal_suffix(bool reversed, std::ptrdiff_t& p) const
+    {
+      std::ptrdiff_t ms = -1;
+      std::ptrdiff_t j = 0;
+      std::ptrdiff_t k = 1;
+      p = 1;
+      while (j + k < m_size) {
+        const auto& a = m_first[j + k];
+        const auto& b = m_first[ms + k];
+        if (reversed ? b < a : a < b) {
+          j += k;
+          k = 1;
+          p = j - ms;
+        } else if (a == b) {
+          if (k != p) {
+            ++k;
+          } else {
+            j += p;
+            k = 1;
+          }
+        } else {
+          ms = j;
+          j = ms + 1;
+          k = p = 1;
+        }
+      }
+      return ms;
+    }
+
+    RandomIt m_first;
+    std::ptrdiff_t m_size;
+    std::ptrdiff_t m_ell = -1;
+    std::ptrdiff_t m_period = 1;
+    bool m_periodic = false;
+  };
+
+  namespace detail
+  {
+    // where search and find_end can use a two-way searcher by default
+    template <class It1, class It2>
+    inline constexpr bool two_way_searchable_v =
+      std::is_base_of_v<std::random_access_iterator_tag,
+                        typename std::iterator_traits<It1>::iterator_category>
+      && std::is_base_of_v<std::random_access_iterator_tag,
+                           typename std::iterator_traits<It2>::iterator_category>
+      && std::is_integral_v<typename std::iterator_traits<It2>::value_type>
+      && std::is_same_v<std::remove_cv_t<typename std::iterator_traits<It1>::value_type>,
+                        std::remove_cv_t<typename std::iterator_traits<It2>::value_type>>;
+  }
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Runtime fast paths for the non-modifying algorithms on contiguous ranges of
+// bitwise-comparable values. None of this is constexpr: the algorithms only
+// call it when they are not being constant-evaluated.
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define CX_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define CX_SIMD_SSE2 0
+#endif
+
+#if defined(__GNUC__) && defined(__AVX2__)
+#define CX_SIMD_AVX2 1
+#include <immintrin.h>
+#else
+#define CX_SIMD_AVX2 0
+#endif
+
+namespace cx
+{
+  namespace detail
+  {
+    // Pointers are contiguous iterators, and with C++20 we can ask about
+    // anything else (e.g. checked iterators).
+    template <typename It>
+    inline constexpr bool is_contiguous_iterator_v =
+      std::is_pointer_v<It>
+#ifdef __cpp_lib_concepts
+      || std::contiguous_iterator<It>
+#endif
+      ;
+
+    template <typename It>
+    constexpr auto to_pointer(It it)
+    {
+#ifdef __cpp_lib_concepts
+      if constexpr (!std::is_pointer_v<It>) {
+        return std::to_address(it);
+      } else
+#endif
+      {
+        return it;
+      }
+    }
+
+    // Values for which == is the same as comparing their bytes (so not
+    // floating point, where 0.0 == -0.0 and NaN != NaN).
+    template <typename T>
+    inline constexpr bool is_bitwise_comparable_v =
+      std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+    template <typename It>
+    using iter_value_t = std::remove_cv_t<typename std::iterator_traits<It>::value_type>;
+
+    // find a single byte in a contiguous range
+    template <typename It, typename T>
+    inline constexpr bool fast_find_v =
+      is_contiguous_iterator_v<It> && sizeof(iter_value_t<It>) == 1
+      && is_bitwise_comparable_v<iter_value_t<It>>
+      && std::is_same_v<iter_value_t<It>, std::remove_cv_t<T>>;
+
+    // compare two contiguous ranges of the same bitwise-comparable type
+    template <typename It1, typename It2>
+    inline constexpr bool fast_compare_v =
+      is_contiguous_iterator_v<It1> && is_contiguous_iterator_v<It2>
+      && is_bitwise_comparable_v<iter_value_t<It1>>
+      && std::is_same_v<iter_value_t<It1>, iter_value_t<It2>>;
+
+#if CX_SIMD_SSE2
+    inline std::size_t lowest_bit(unsigned mask)
+    {
+      return static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+#endif
+
+    // the index of the first byte equal to c, or n
+    inline std::size_t find_byte(const void* data, std::size_t n, unsigned char c)
+    {
+      const auto p = static_cast<const unsigned char*>(data);
+      std::size_t i = 0;
+#if CX_SIMD_AVX2
+      const __m256i v32 = _mm256_set1_epi8(static_cast<char>(c));
+      for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const auto m = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v32)));
+        if (m != 0) return i + lowest_bit(m);
+      }
+#endif
+#if CX_SIMD_SSE2
+      const __m128i v16 = _mm_set1_epi8(static_cast<char>(c));
+      for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const auto m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, v16)));
+        if (m != 0) return i + lowest_bit(m);
+      }
+      for (; i < n && p[i] != c; ++i);
+      return i;
+#else
+      const auto r = std::memchr(p, c, n);
+      return r ? static_cast<std::size_t>(static_cast<const unsigned char*>(r) - p) : n;
+#endif
+    }
+
+    // the index of the first byte that differs between a and b, or n
+    inline std::size_t mismatch_bytes(const void* a, const void* b, std::size_t n)
+    {
+      const auto p = static_cast<const unsigned char*>(a);
+      const auto q = static_cast<const unsigned char*>(b);
+      std::size_t i = 0;
+#if CX_SIMD_AVX2
+      for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+        const auto m = ~static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (m != 0) return i + lowest_bit(m);
+      }
+#endif
+#if CX_SIMD_SSE2
+      for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + i));
+        const auto m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)))
+          ^ 0xffffu;
+        if (m != 0) return i + lowest_bit(m);
+      }
+#endif
+      for (; i < n && p[i] == q[i]; ++i);
+      return i;
+    }
+
+    // the number of leading elements that two contiguous ranges share
+    template <typename It1, typename It2>
+    std::size_t fast_mismatch(It1 first1, std::size_t n1, It2 first2, std::size_t n2)
+    {
+      using T = iter_value_t<It1>;
+      const auto n = n1 < n2 ? n1 : n2;
+      if (n == 0) return 0;
+      return mismatch_bytes(detail::to_pointer(first1), detail::to_pointer(first2),
+                            n * sizeof(T)) / sizeof(T);
+    }
+  }
+}
@@ -0,0 +1,491 @@
+#pragma once
+
+#include "cx_binary_search.h"
+#include "cx_config.h"
+#include "cx_mod_seq.h"
+#include "cx_nonmod_seq.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cx
+{
+  template <class ForwardIt, class Compare>
+  constexpr ForwardIt is_sorted_until(ForwardIt first, ForwardIt last, Compare comp)
+  {
+    if (first != last) {
+      for (auto next = std::next(first); next != last; first = next++) {
+        if (comp(*next, *first)) return next;
+      }
+    }
+    return last;
+  }
+
+  template <class ForwardIt>
+  constexpr ForwardIt is_sorted_until(ForwardIt first, ForwardIt last)
+  {
+    return cx::is_sorted_until(first, last, std::less<>{});
+  }
+
+  template <class ForwardIt, class Compare>
+  constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp)
+  {
+    return cx::is_sorted_until(first, last, comp) == last;
+  }
+
+  template <class ForwardIt>
+  constexpr bool is_sorted(ForwardIt first, ForwardIt last)
+  {
+    return cx::is_sorted_until(first, last) == last;
+  }
+
+  namespace detail
+  {
+    // below this size, insertion sort beats partitioning
+    inline constexpr std::ptrdiff_t sort_threshold = 16;
+
+    template <class RandomIt, class Compare>
+    constexpr void insertion_sort(RandomIt first, RandomIt last, Compare& comp)
+    {
+      if (first == last) return;
+      for (auto i = first + 1; i != last; ++i) {
+        auto v = std::move(*i);
+        auto j = i;
+        for (; j != first && comp(v, *(j - 1)); --j) {
+          *j = std::move(*(j - 1));
+        }
+        *j = std::move(v);
+      }
+    }
+
+    // heaps (for the introsort fallback and partial_sort) are max-heaps
+    template <class RandomIt, class Distance, class Compare>
+    constexpr void sift_down(RandomIt first, Distance len, Distance hole, Compare& comp)
+    {
+      auto v = std::move(first[hole]);
+      for (auto child = 2 * hole + 1; child < len; child = 2 * hole + 1) {
+        if (child + 1 < len && comp(first[child], first[child + 1])) ++child;
+        if (!comp(v, first[child])) break;
+        first[hole] = std::move(first[child]);
+        hole = child;
+      }
+      first[hole] = std::move(v);
+    }
+
+    template <class RandomIt, class Compare>
+    constexpr void make_heap(RandomIt first, RandomIt last, Compare& comp)
+    {
+      const auto len = last - first;
+      for (auto hole = len / 2; hole-- > 0;) {
+        detail::sift_down(first, len, hole, comp);
+      }
+    }
+
+    template <class RandomIt, class Compare>
+    constexpr void sort_heap(RandomIt first, RandomIt last, Compare& comp)
+    {
+      for (auto len = last - first; len-- > 1;) {
+        cx::iter_swap(first, first + len);
+        detail::sift_down(first, len, decltype(len){}, comp);
+      }
+    }
+
+    // leave the smallest (middle - first) elements in a heap at the front
+    template <class RandomIt, class Compare>
+    constexpr void heap_select(RandomIt first, RandomIt middle, RandomIt last,
+                               Compare& comp)
+    {
+      detail::make_heap(first, middle, comp);
+      const auto len = middle - first;
+      for (auto i = middle; i < last; ++i) {
+        if (comp(*i, *first)) {
+          cx::iter_swap(i, first);
+          detail::sift_down(first, len, decltype(len){}, comp);
+        }
+      }
+    }
+
+    template <class RandomIt, class Compare>
+    constexpr void move_median_to_first(RandomIt result, RandomIt a, RandomIt b,
+                                        RandomIt c, Compare& comp)
+    {
+      if (comp(*a, *b)) {
+        if (comp(*b, *c)) cx::iter_swap(result, b);
+        else if (comp(*a, *c)) cx::iter_swap(result, c);
+        else cx::iter_swap(result, a);
+      } else if (comp(*a, *c)) {
+        cx::iter_swap(result, a);
+      } else if (comp(*b, *c)) {
+        cx::iter_swap(result, c);
+      } else {
+        cx::iter_swap(result, b);
+      }
+    }
+
+    // Partition around a median-of-three pivot, which is left at first. The
+    // median guarantees an element on each side to stop the scans, so they
+    // need no bounds checks.
+    template <class RandomIt, class Compare>
+    constexpr RandomIt partition_pivot(RandomIt first, RandomIt last, Compare& comp)
+    {
+      const auto mid = first + (last - first) / 2;
+      detail::move_median_to_first(first, first + 1, mid, last - 1, comp);
+      auto lo = first + 1;
+      auto hi = last;
+      while (true) {
+        while (comp(*lo, *first)) ++lo;
+        --hi;
+        while (comp(*first, *hi)) --hi;
+        if (!(lo < hi)) return lo;
+        cx::iter_swap(lo, hi);
+        ++lo;
+      }
+    }
+
+    template <class Distance>
+    constexpr Distance depth_limit(Distance n)
+    {
+      Distance depth = 0;
+      for (; n > 1; n /= 2) depth += 2;
+      return depth;
+    }
+
+    template <class RandomIt, class Distance, class Compare>
+    constexpr void introsort_loop(RandomIt first, RandomIt last, Distance depth,
+                                  Compare& comp)
+    {
+      while (last - first > sort_threshold) {
+        if (depth == 0) {
+          // partitioning is going quadratic: fall back to heapsort
+          detail::heap_select(first, last, last, comp);
+          detail::sort_heap(first, last, comp);
+          return;
+        }
+        --depth;
+        const auto cut = detail::partition_pivot(first, last, comp);
+        detail::introsort_loop(cut, last, depth, comp);
+        last = cut;
+      }
+    }
+
+    // The merge for constant evaluation, where we can't allocate: split the
+    // longer run in half, rotate the matching part of the other run into
+    // place, and recurse on both sides.
+    template <class RandomIt, class Compare>
+    constexpr void merge_without_buffer(RandomIt first, RandomIt middle,
+                                        RandomIt last, Compare& comp)
+    {
+      const auto len1 = middle - first;
+      const auto len2 = last - middle;
+      if (len1 == 0 || len2 == 0) return;
+      if (len1 + len2 == 2) {
+        if (comp(*middle, *first)) cx::iter_swap(first, middle);
+        return;
+      }
+
+      auto first_cut = first;
+      auto second_cut = middle;
+      if (len1 > len2) {
+        first_cut += len1 / 2;
+        second_cut = cx::lower_bound(middle, last, *first_cut, comp);
+      } else {
+        second_cut += len2 / 2;
+        first_cut = cx::upper_bound(first, middle, *second_cut, comp);
+      }
+      const auto new_middle = cx::rotate(first_cut, middle, second_cut);
+      detail::merge_without_buffer(first, first_cut, new_middle, comp);
+      detail::merge_without_buffer(new_middle, second_cut, last, comp);
+    }
+
+    // The merge for runtime: move the shorter run out into raw storage (which
+    // needs room for half the range at most), and merge back into place from
+    // there.
+    template <class RandomIt, class T, class Compare>
+    void merge_with_buffer(RandomIt first, RandomIt middle, RandomIt last,
+                           T* buf, Compare& comp)
+    {
+      if (middle - first <= last - middle) {
+        T* const buf_last = std::uninitialized_move(first, middle, buf);
+        T* b = buf;
+        auto out = first;
+        while (b != buf_last && middle != last) {
+          if (comp(*middle, *b)) *out++ = std::move(*middle++);
+          else *out++ = std::move(*b++);
+        }
+        std::move(b, buf_last, out);
+        std::destroy(buf, buf_last);
+      } else {
+        T* const buf_last = std::uninitialized_move(middle, last, buf);
+        T* b = buf_last;
+        auto out = last;
+        while (b != buf && first != middle) {
+          if (comp(*(b - 1), *(middle - 1))) *--out = std::move(*--middle);
+          else *--out = std::move(*--b);
+        }
+        std::move_backward(buf, b, out);
+        std::destroy(buf, buf_last);
+      }
+    }
+
+    template <typename T>
+    struct temporary_buffer
+    {
+      explicit temporary_buffer(std::size_t n)
+        : m_data(std::allocator<T>{}.allocate(n)), m_size(n)
+      {}
+      temporary_buffer(const temporary_buffer&) = delete;
+      temporary_buffer& operator=(const temporary_buffer&) = delete;
+      ~temporary_buffer() { std::allocator<T>{}.deallocate(m_data, m_size); }
+
+      T* m_data;
+      std::size_t m_size;
+    };
+
+    template <class RandomIt, class Compare>
+    void inplace_merge_with_buffer(RandomIt first, RandomIt middle, RandomIt last,
+                                   Compare& comp)
+    {
+      using T = typename std::iterator_traits<RandomIt>::value_type;
+      const auto len = std::min(middle - first, last - middle);
+      temporary_buffer<T> buf(static_cast<std::size_t>(len));
+      detail::merge_with_buffer(first, middle, last, buf.m_data, comp);
+    }
+
+    template <class RandomIt, class Compare, class Merge>
+    constexpr void stable_sort_impl(RandomIt first, RandomIt last, Compare& comp,
+                                    Merge&& merge)
+    {
+      using D = typename std::iterator_traits<RandomIt>::difference_type;
+      const D n = last - first;
+      const D run = 32;
+      for (D i = 0; i < n; i += run) {
+        detail::insertion_sort(first + i, first + (n - i < run ? n : i + run), comp);
+      }
+      for (auto width = run; width < n; width *= 2) {
+        for (D lo = 0; lo < n - width; lo += 2 * width) {
+          const auto hi = n - lo - width < width ? n : lo + 2 * width;
+          merge(first + lo, first + lo + width, first + hi);
+        }
+      }
+    }
+
+    template <class RandomIt, class Compare>
+    void stable_sort_with_buffer(RandomIt first, RandomIt last, Compare& comp)
+    {
+      using T = typename std::iterator_traits<RandomIt>::value_type;
+      // only the shorter run of each merge is buffered
+      temporary_buffer<T> buf(static_cast<std::size_t>((last - first) / 2 + 1));
+      detail::stable_sort_impl(first, last, comp, [&] (auto f, auto m, auto l) {
+          detail::merge_with_buffer(f, m, l, buf.m_data, comp);
+      });
+    }
+  }
+
+  // introsort: quicksort with median-of-three pivots, which falls back to
+  // heapsort when the recursion gets too deep, and finishes small partitions
+  // with an insertion sort
+  template <class RandomIt, class Compare>
+  constexpr void sort(RandomIt first, RandomIt last, Compare comp)
+  {
+    const auto n = last - first;
+    if (n < 2) return;
+    detail::introsort_loop(first, last, detail::depth_limit(n), comp);
+    detail::insertion_sort(first, last, comp);
+  }
+
+  template <class RandomIt>
+  constexpr void sort(RandomIt first, RandomIt last)
+  {
+    cx::sort(first, last, std::less<>{});
+  }
+
+  template <class RandomIt, class Compare>
+  constexpr void partial_sort(RandomIt first, RandomIt middle, RandomIt last,
+                              Compare comp)
+  {
+    detail::heap_select(first, middle, last, comp);
+    detail::sort_heap(first, middle, comp);
+  }
+
+  template <class RandomIt>
+  constexpr void partial_sort(RandomIt first, RandomIt middle, RandomIt last)
+  {
+    cx::partial_sort(first, middle, last, std::less<>{});
+  }
+
+  // introselect: partition only the side that contains nth
+  template <class RandomIt, class Compare>
+  constexpr void nth_element(RandomIt first, RandomIt nth, RandomIt last,
+                             Compare comp)
+  {
+    if (nth == last) return;
+    auto depth = detail::depth_limit(last - first);
+    while (last - first > 3) {
+      if (depth == 0) {
+        detail::heap_select(first, nth + 1, last, comp);
+        cx::iter_swap(first, nth);
+        return;
+      }
+      --depth;
+      const auto cut = detail::partition_pivot(first, last, comp);
+      if (cut <= nth) first = cut;
+      else last = cut;
+    }
+    detail::insertion_sort(first, last, comp);
+  }
+
+  template <class RandomIt>
+  constexpr void nth_element(RandomIt first, RandomIt nth, RandomIt last)
+  {
+    cx::nth_element(first, nth, last, std::less<>{});
+  }
+
+  template <class RandomIt, class Compare>
+  constexpr void inplace_merge(RandomIt first, RandomIt middle, RandomIt last,
+                               Compare comp)
+  {
+    if (!cx::is_constant_evaluated()) {
+      detail::inplace_merge_with_buffer(first, middle, last, comp);
+    } else {
+      detail::merge_without_buffer(first, middle, last, comp);
+    }
+  }
+
+  template <class RandomIt>
+  constexpr void inplace_merge(RandomIt first, RandomIt middle, RandomIt last)
+  {
+    cx::inplace_merge(first, middle, last, std::less<>{});
+  }
+
+  // bottom-up merge sort: insertion sort short runs, then merge pairs of runs
+  // of doubling width (with a single buffer at runtime)
+  template <class RandomIt, class Compare>
+  constexpr void stable_sort(RandomIt first, RandomIt last, Compare comp)
+  {
+    if (!cx::is_constant_evaluated()) {
+      detail::stable_sort_with_buffer(first, last, comp);
+    } else {
+      detail::stable_sort_impl(first, last, comp, [&] (auto f, auto m, auto l) {
+          detail::merge_without_buffer(f, m, l, comp);
+      });
+    }
+  }
+
+  template <class RandomIt>
+  constexpr void stable_sort(RandomIt first, RandomIt last)
+  {
+    cx::stable_sort(first, last, std::less<>{});
+  }
+
+  namespace detail
+  {
+    // map an integer key to an unsigned one with the same ordering
+    template <typename K>
+    constexpr auto radix_key(K k)
+    {
+      static_assert(std::is_integral_v<K> && !std::is_same_v<K, bool>,
+                    "radix_sort needs integer keys");
+      using U = std::make_unsigned_t<K>;
+      auto u = static_cast<U>(k);
+      if constexpr (std::is_signed_v<K>) {
+        u = static_cast<U>(u ^ static_cast<U>(U{1} << (sizeof(K) * 8 - 1)));
+      }
+      return u;
+    }
+
+    template <typename U>
+    constexpr std::size_t radix_digit(U u, std::size_t pass)
+    {
+      return static_cast<std::size_t>((u >> (pass * 8)) & 0xffu);
+    }
+
+    // one stable counting pass on a byte of the key, from src to dst
+    template <class SrcIt, class DstIt, class Key>
+    constexpr void radix_pass(SrcIt first, SrcIt last, DstIt d_first,
+                              const std::size_t (&count)[256], std::size_t pass,
+                              Key& key)
+    {
+      std::size_t offset[256]{};
+      for (std::size_t i = 1; i < 256; ++i) {
+        offset[i] = offset[i - 1] + count[i - 1];
+      }
+      for (; first != last; ++first) {
+        const auto d = detail::radix_digit(detail::radix_key(key(*first)), pass);
+        d_first[static_cast<std::ptrdiff_t>(offset[d]++)] = std::move(*first);
+      }
+    }
+  }
+
+  // LSD radix sort on an integer key (by default, the element itself): one
+  // stable counting pass per byte, skipping bytes that are the same
+  // throughout. It ping-pongs between the range and scratch space of the
+  // same size starting at d_scratch, and leaves the result in the range.
+  template <class RandomIt, class ScratchIt, class Key>
+  constexpr void radix_sort(RandomIt first, RandomIt last, ScratchIt d_scratch,
+                            Key key)
+  {
+    using K = decltype(detail::radix_key(key(*first)));
+    constexpr std::size_t passes = sizeof(K);
+    const auto n = static_cast<std::size_t>(last - first);
+
+    std::size_t count[passes][256]{};
+    for (auto i = first; i != last; ++i) {
+      const auto u = detail::radix_key(key(*i));
+      for (std::size_t p = 0; p < passes; ++p) {
+        ++count[p][detail::radix_digit(u, p)];
+      }
+    }
+
+    const auto scratch_last = d_scratch + static_cast<std::ptrdiff_t>(n);
+    bool in_scratch = false;
+    for (std::size_t p = 0; p < passes; ++p) {
+      if (cx::find(std::cbegin(count[p]), std::cend(count[p]), n)
+          != std::cend(count[p])) {
+        continue;
+      }
+      if (in_scratch) {
+        detail::radix_pass(d_scratch, scratch_last, first, count[p], p, key);
+      } else {
+        detail::radix_pass(first, last, d_scratch, count[p], p, key);
+      }
+      in_scratch = !in_scratch;
+    }
+    if (in_scratch) cx::move(d_scratch, scratch_last, first);
+  }
+
+  namespace detail
+  {
+    template <class RandomIt, class Key>
+    void radix_sort_with_buffer(RandomIt first, RandomIt last, Key& key)
+    {
+      using T = typename std::iterator_traits<RandomIt>::value_type;
+      std::vector<T> scratch(first, last);
+      cx::radix_sort(first, last, scratch.begin(), key);
+    }
+  }
+
+  template <class RandomIt, class Key>
+  constexpr void radix_sort(RandomIt first, RandomIt last, Key key)
+  {
+    if (!cx::is_constant_evaluated()) {
+      detail::radix_sort_with_buffer(first, last, key);
+    } else {
+      // without scratch space, a stable sort on the key gives the same result
+      cx::stable_sort(first, last, [&] (const auto& a, const auto& b) {
+          return detail::radix_key(key(a)) < detail::radix_key(key(b));
+      });
+    }
+  }
+
+  template <class RandomIt>
+  constexpr void radix_sort(RandomIt first, RandomIt last)
+  {
+    cx::radix_sort(first, last, [] (const auto& v) { return v; });
+  }
+}
@@ -2,3 +2,6 @@
 
 #include "algorithms/cx_nonmod_seq.h"
 #include "algorithms/cx_mod_seq.h"
+#include "algorithms/cx_binary_search.h"
+#include "algorithms/cx_sorting.h"
+#include "algorithms/cx_numeric.h"
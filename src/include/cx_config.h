@@ -0,0 +1,86 @@
+#pragma once
+
+// Language features that let more of the library work in constant
+// expressions, when they are available.
+
+// C++20 allows non-trivial destructors, and changing the active member of a
+// union, in constant expressions
+#if __cpp_constexpr >= 201907L
+#define CX_CONSTEXPR20 constexpr
+#else
+#define CX_CONSTEXPR20
+#endif
+
+// C++20 allows memory to be allocated (and freed again) during constant
+// evaluation
+#ifdef __cpp_constexpr_dynamic_alloc
+#define CX_CONSTEXPR_ALLOCATION 1
+#else
+#define CX_CONSTEXPR_ALLOCATION 0
+#endif
+
+// C++20 allows class types (e.g. cx::fixed_string) as template parameters
+#if defined(__cpp_nontype_template_args)
+#if __cpp_nontype_template_args >= 201911L
+#define CX_HAS_CLASS_NTTP 1
+#endif
+#endif
+#ifndef CX_HAS_CLASS_NTTP
+#define CX_HAS_CLASS_NTTP 0
+#endif
+
+// Whether we are being evaluated at compile time, so that runtime-only fast
+// paths (temporary buffers, SIMD and so on) can be taken the rest of the time.
+// Where the compiler can't tell us, we always take the constexpr path.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define CX_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+#ifndef CX_HAS_IS_CONSTANT_EVALUATED
+#define CX_HAS_IS_CONSTANT_EVALUATED 0
+#endif
+
+// Reinterpreting the bytes of a value (e.g. the bits of a double) in a
+// constant expression needs compiler support; without it, cx::bit_cast only
+// works at runtime.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define CX_HAS_BIT_CAST 1
+#endif
+#endif
+#ifndef CX_HAS_BIT_CAST
+#define CX_HAS_BIT_CAST 0
+#endif
+
+#if CX_HAS_BIT_CAST
+#define CX_BIT_CAST_CONSTEXPR constexpr
+#else
+#define CX_BIT_CAST_CONSTEXPR
+#include <cstring>
+#endif
+
+namespace cx
+{
+  constexpr bool is_constant_evaluated() noexcept
+  {
+#if CX_HAS_IS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+  }
+
+  template <typename To, typename From>
+  CX_BIT_CAST_CONSTEXPR To bit_cast(const From& from) noexcept
+  {
+    static_assert(sizeof(To) == sizeof(From), "bit_cast needs types of the same size");
+#if CX_HAS_BIT_CAST
+    return __builtin_bit_cast(To, from);
+#else
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+#endif
+  }
+}
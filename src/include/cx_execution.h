@@ -0,0 +1,504 @@
+#pragma once
+
+#include "cx_algorithm.h"
+#include "cx_config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Execution-policy overloads of the algorithms, as with std: pass
+// cx::execution::par first to spread the work over a pool of threads. In
+// constant evaluation (and for small or non-random-access ranges) they run
+// sequentially, so the same call works at compile time and at runtime.
+
+namespace cx
+{
+  namespace execution
+  {
+    struct sequenced_policy {};
+    struct parallel_policy {};
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+  }
+
+  template <typename T>
+  struct is_execution_policy : std::false_type {};
+  template <>
+  struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+  template <>
+  struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+
+  template <typename T>
+  inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+  namespace detail
+  {
+    // A minimal work-stealing pool: each worker has its own queue, takes work
+    // from the back of it, and steals from the front of the others' when it
+    // runs dry. A thread waiting for a batch of work to finish helps with it
+    // (from any queue) rather than blocking, so a parallel algorithm can
+    // itself be called from a task.
+    class work_stealing_pool
+    {
+    public:
+      explicit work_stealing_pool(std::size_t workers)
+      {
+        // the last queue is shared by threads outside the pool
+        for (std::size_t i = 0; i <= workers; ++i) {
+          m_queues.push_back(std::make_unique<queue>());
+        }
+        for (std::size_t i = 0; i < workers; ++i) {
+          m_threads.emplace_back([this, i] { run(i); });
+        }
+      }
+
+      work_stealing_pool(const work_stealing_pool&) = delete;
+      work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+      ~work_stealing_pool()
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_wake_mutex);
+          m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+      }
+
+      // including the calling thread
+      std::size_t concurrency() const { return m_threads.size() + 1; }
+
+      // call f(i) for each i in [0, n), and return when they are all done
+      // (rethrowing the first exception, if any)
+      template <typename F>
+      void parallel_for(std::size_t n, F&& f)
+      {
+        batch b;
+        b.remaining = n;
+        const auto self = current_queue();
+        m_pending.fetch_add(n, std::memory_order_release);
+        for (std::size_t i = 0; i < n; ++i) {
+          auto& q = *m_queues[(self + i) % m_queues.size()];
+          std::lock_guard<std::mutex> lock(q.mutex);
+          q.tasks.push_back([&b, &f, i] {
+            try {
+              f(i);
+            } catch (...) {
+              std::lock_guard<std::mutex> l(b.mutex);
+              if (!b.error) b.error = std::current_exception();
+            }
+            b.remaining.fetch_sub(1, std::memory_order_acq_rel);
+          });
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_wake_mutex);
+        }
+        m_wake.notify_all();
+
+        while (b.remaining.load(std::memory_order_acquire) != 0) {
+          task t;
+          if (take(self, t)) t();
+          else std::this_thread::yield();
+        }
+        if (b.error) std::rethrow_exception(b.error);
+      }
+
+    private:
+      using task = std::function<void()>;
+
+      struct queue
+      {
+        std::mutex mutex;
+        std::deque<task> tasks;
+      };
+
+      struct batch
+      {
+        std::atomic<std::size_t> remaining{0};
+        std::mutex mutex;
+        std::exception_ptr error;
+      };
+
+      static std::size_t& worker_index()
+      {
+        static thread_local std::size_t index = static_cast<std::size_t>(-1);
+        return index;
+      }
+
+      std::size_t current_queue() const
+      {
+        const auto i = worker_index();
+        return i < m_threads.size() ? i : m_threads.size();
+      }
+
+      bool take(std::size_t self, task& t)
+      {
+        {
+          auto& q = *m_queues[self];
+          std::lock_guard<std::mutex> lock(q.mutex);
+          if (!q.tasks.empty()) {
+            t = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+          }
+        }
+        for (std::size_t k = 1; k < m_queues.size(); ++k) {
+          auto& q = *m_queues[(self + k) % m_queues.size()];
+          std::lock_guard<std::mutex> lock(q.mutex);
+          if (!q.tasks.empty()) {
+            t = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void run(std::size_t self)
+      {
+        worker_index() = self;
+        while (true) {
+          task t;
+          if (take(self, t)) {
+            t();
+            continue;
+          }
+          std::unique_lock<std::mutex> lock(m_wake_mutex);
+          m_wake.wait(lock, [this] {
+            return m_stop || m_pending.load(std::memory_order_acquire) != 0;
+          });
+          if (m_stop) return;
+        }
+      }
+
+      std::vector<std::unique_ptr<queue>> m_queues;
+      std::vector<std::thread> m_threads;
+      std::atomic<std::size_t> m_pending{0};
+      std::mutex m_wake_mutex;
+      std::condition_variable m_wake;
+      bool m_stop = false;
+    };
+
+    inline work_stealing_pool& default_pool()
+    {
+      static work_stealing_pool pool(
+          std::max(std::thread::hardware_concurrency(), 1u) - 1);
+      return pool;
+    }
+
+    // below this many elements, splitting the work costs more than it saves
+    inline constexpr std::ptrdiff_t parallel_grain = 1 << 14;
+
+    template <typename It>
+    inline constexpr bool is_random_access_v =
+      std::is_base_of_v<std::random_access_iterator_tag,
+                        typename std::iterator_traits<It>::iterator_category>;
+
+    template <typename Policy, typename It>
+    constexpr bool run_parallel(It first, It last)
+    {
+      if constexpr (std::is_same_v<std::decay_t<Policy>, execution::parallel_policy>
+                    && is_random_access_v<It>) {
+        return !cx::is_constant_evaluated() && last - first >= 2 * parallel_grain
+          && detail::default_pool().concurrency() > 1;
+      } else {
+        return false;
+      }
+    }
+
+    // a few chunks per thread, to even out the load
+    inline std::ptrdiff_t chunk_count(std::ptrdiff_t n)
+    {
+      const auto max_chunks = static_cast<std::ptrdiff_t>(4 * default_pool().concurrency());
+      return std::max<std::ptrdiff_t>(1, std::min(max_chunks, n / parallel_grain));
+    }
+
+    // call f(chunk_first, chunk_last, chunk_index) on contiguous chunks of
+    // [0, n), and return the number of chunks
+    template <typename F>
+    std::size_t for_chunks(std::ptrdiff_t n, F&& f)
+    {
+      const auto chunks = detail::chunk_count(n);
+      default_pool().parallel_for(static_cast<std::size_t>(chunks), [&] (std::size_t c) {
+          const auto i = static_cast<std::ptrdiff_t>(c);
+          f(n * i / chunks, n * (i + 1) / chunks, c);
+      });
+      return static_cast<std::size_t>(chunks);
+    }
+
+    template <typename RandomIt, typename Pred>
+    RandomIt parallel_find_if(RandomIt first, RandomIt last, Pred& p)
+    {
+      // chunks after the best match so far needn't look
+      const auto n = last - first;
+      std::atomic<std::ptrdiff_t> best{n};
+      detail::for_chunks(n, [&] (std::ptrdiff_t b, std::ptrdiff_t e, std::size_t) {
+          for (auto i = b; i < e && i < best.load(std::memory_order_relaxed); ++i) {
+            if (p(first[i])) {
+              auto cur = best.load(std::memory_order_relaxed);
+              while (i < cur && !best.compare_exchange_weak(cur, i));
+              return;
+            }
+          }
+      });
+      return first + best.load();
+    }
+
+    template <typename RandomIt, typename Pred>
+    typename std::iterator_traits<RandomIt>::difference_type
+    parallel_count_if(RandomIt first, RandomIt last, Pred& p)
+    {
+      std::atomic<typename std::iterator_traits<RandomIt>::difference_type> count{0};
+      detail::for_chunks(last - first, [&] (std::ptrdiff_t b, std::ptrdiff_t e, std::size_t) {
+          count.fetch_add(cx::count_if(first + b, first + e, p), std::memory_order_relaxed);
+      });
+      return count.load();
+    }
+
+    template <typename RandomIt, typename F>
+    void parallel_for_each(RandomIt first, RandomIt last, F&& f)
+    {
+      detail::for_chunks(last - first, [&] (std::ptrdiff_t b, std::ptrdiff_t e, std::size_t) {
+          f(b, e);
+      });
+    }
+
+    template <typename RandomIt, typename T, typename BinaryOp>
+    T parallel_reduce(RandomIt first, RandomIt last, T init, BinaryOp& op)
+    {
+      const auto n = last - first;
+      std::vector<std::unique_ptr<T>> partials(
+          static_cast<std::size_t>(detail::chunk_count(n)));
+      const auto chunks = detail::for_chunks(
+          n, [&] (std::ptrdiff_t b, std::ptrdiff_t e, std::size_t c) {
+            T acc = first[b];
+            for (auto i = b + 1; i < e; ++i) acc = op(std::move(acc), first[i]);
+            partials[c] = std::make_unique<T>(std::move(acc));
+      });
+      for (std::size_t c = 0; c < chunks; ++c) {
+        init = op(std::move(init), std::move(*partials[c]));
+      }
+      return init;
+    }
+
+    // sort chunks in parallel, then merge pairs of them, in parallel, in
+    // rounds of doubling width
+    template <typename RandomIt, typename Compare>
+    void parallel_sort(RandomIt first, RandomIt last, Compare& comp)
+    {
+      const auto n = last - first;
+      const auto chunks = static_cast<std::size_t>(detail::chunk_count(n));
+      std::vector<std::ptrdiff_t> bounds;
+      for (std::size_t c = 0; c <= chunks; ++c) {
+        bounds.push_back(n * static_cast<std::ptrdiff_t>(c)
+                         / static_cast<std::ptrdiff_t>(chunks));
+      }
+      auto& pool = default_pool();
+      pool.parallel_for(chunks, [&] (std::size_t c) {
+          cx::sort(first + bounds[c], first + bounds[c + 1], comp);
+      });
+      for (std::size_t width = 1; width < chunks; width *= 2) {
+        const auto merges = (chunks + 2 * width - 1) / (2 * width);
+        pool.parallel_for(merges, [&] (std::size_t m) {
+            const auto lo = 2 * width * m;
+            const auto mid = std::min(lo + width, chunks);
+            const auto hi = std::min(lo + 2 * width, chunks);
+            cx::inplace_merge(first + bounds[lo], first + bounds[mid],
+                              first + bounds[hi], comp);
+        });
+      }
+    }
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt find_if(ExecutionPolicy&&, ForwardIt first, ForwardIt last,
+                              UnaryPredicate p)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      return detail::parallel_find_if(first, last, p);
+    }
+    return cx::find_if(first, last, p);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class T,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt find(ExecutionPolicy&&, ForwardIt first, ForwardIt last,
+                           const T& value)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      auto p = [&] (const auto& v) { return v == value; };
+      return detail::parallel_find_if(first, last, p);
+    }
+    return cx::find(first, last, value);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt find_if_not(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                                  UnaryPredicate p)
+  {
+    return cx::find_if(std::forward<ExecutionPolicy>(policy), first, last,
+                       [&] (const auto& v) { return !p(v); });
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr bool all_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        UnaryPredicate p)
+  {
+    return cx::find_if_not(std::forward<ExecutionPolicy>(policy), first, last, p) == last;
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr bool any_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                        UnaryPredicate p)
+  {
+    return cx::find_if(std::forward<ExecutionPolicy>(policy), first, last, p) != last;
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr bool none_of(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last,
+                         UnaryPredicate p)
+  {
+    return cx::find_if(std::forward<ExecutionPolicy>(policy), first, last, p) == last;
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class UnaryPredicate,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr typename std::iterator_traits<ForwardIt>::difference_type
+  count_if(ExecutionPolicy&&, ForwardIt first, ForwardIt last, UnaryPredicate p)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      return detail::parallel_count_if(first, last, p);
+    }
+    return cx::count_if(first, last, p);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class T,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr typename std::iterator_traits<ForwardIt>::difference_type
+  count(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, const T& value)
+  {
+    return cx::count_if(std::forward<ExecutionPolicy>(policy), first, last,
+                        [&] (const auto& v) { return v == value; });
+  }
+
+  template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt2 copy(ExecutionPolicy&&, ForwardIt1 first, ForwardIt1 last,
+                            ForwardIt2 d_first)
+  {
+    if constexpr (detail::is_random_access_v<ForwardIt2>) {
+      if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+        detail::parallel_for_each(first, last, [&] (std::ptrdiff_t b, std::ptrdiff_t e) {
+            cx::copy(first + b, first + e, d_first + b);
+        });
+        return d_first + (last - first);
+      }
+    }
+    return cx::copy(first, last, d_first);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class T,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr void fill(ExecutionPolicy&&, ForwardIt first, ForwardIt last, const T& value)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      detail::parallel_for_each(first, last, [&] (std::ptrdiff_t b, std::ptrdiff_t e) {
+          cx::fill(first + b, first + e, value);
+      });
+    } else {
+      cx::fill(first, last, value);
+    }
+  }
+
+  template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class UnaryOperation,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt2 transform(ExecutionPolicy&&, ForwardIt1 first1, ForwardIt1 last1,
+                                 ForwardIt2 d_first, UnaryOperation unary_op)
+  {
+    if constexpr (detail::is_random_access_v<ForwardIt2>) {
+      if (detail::run_parallel<ExecutionPolicy>(first1, last1)) {
+        detail::parallel_for_each(first1, last1, [&] (std::ptrdiff_t b, std::ptrdiff_t e) {
+            cx::transform(first1 + b, first1 + e, d_first + b, unary_op);
+        });
+        return d_first + (last1 - first1);
+      }
+    }
+    return cx::transform(first1, last1, d_first, unary_op);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class ForwardIt3,
+            class BinaryOperation,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr ForwardIt3 transform(ExecutionPolicy&&, ForwardIt1 first1, ForwardIt1 last1,
+                                 ForwardIt2 first2, ForwardIt3 d_first,
+                                 BinaryOperation binary_op)
+  {
+    if constexpr (detail::is_random_access_v<ForwardIt2>
+                  && detail::is_random_access_v<ForwardIt3>) {
+      if (detail::run_parallel<ExecutionPolicy>(first1, last1)) {
+        detail::parallel_for_each(first1, last1, [&] (std::ptrdiff_t b, std::ptrdiff_t e) {
+            cx::transform(first1 + b, first1 + e, first2 + b, d_first + b, binary_op);
+        });
+        return d_first + (last1 - first1);
+      }
+    }
+    return cx::transform(first1, last1, first2, d_first, binary_op);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class T, class BinaryOperation,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr T reduce(ExecutionPolicy&&, ForwardIt first, ForwardIt last, T init,
+                     BinaryOperation op)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      return detail::parallel_reduce(first, last, std::move(init), op);
+    }
+    return cx::reduce(first, last, std::move(init), op);
+  }
+
+  template <class ExecutionPolicy, class ForwardIt, class T,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr T reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init)
+  {
+    return cx::reduce(std::forward<ExecutionPolicy>(policy), first, last,
+                      std::move(init), std::plus<>{});
+  }
+
+  template <class ExecutionPolicy, class RandomIt, class Compare,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr void sort(ExecutionPolicy&&, RandomIt first, RandomIt last, Compare comp)
+  {
+    if (detail::run_parallel<ExecutionPolicy>(first, last)) {
+      detail::parallel_sort(first, last, comp);
+    } else {
+      cx::sort(first, last, comp);
+    }
+  }
+
+  template <class ExecutionPolicy, class RandomIt,
+            std::enable_if_t<is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int> = 0>
+  constexpr void sort(ExecutionPolicy&& policy, RandomIt first, RandomIt last)
+  {
+    cx::sort(std::forward<ExecutionPolicy>(policy), first, last, std::less<>{});
+  }
+}
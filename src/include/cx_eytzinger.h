@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cx_algorithm.h"
+#include "cx_config.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+
+namespace cx
+{
+  // An eytzinger array holds a sorted set of values in breadth-first order of
+  // the implicit binary search tree over them: the root at index 1, and the
+  // children of k at 2k and 2k+1. A search then walks down the tree reading
+  // memory in a predictable pattern, with the next levels close together so
+  // that they can be prefetched - which beats a plain binary search on large
+  // tables at runtime. The layout is built at compile time, from values in
+  // any order.
+  //
+  // Iteration is in the stored (breadth-first) order, not sorted order.
+  template <typename T, std::size_t N, typename Compare = std::less<>>
+  class eytzinger
+  {
+  public:
+    using value_type = T;
+
+    constexpr explicit eytzinger(const T (&items)[N])
+    {
+      std::array<T, N> sorted{};
+      cx::copy(std::cbegin(items), std::cend(items), sorted.begin());
+      cx::sort(sorted.begin(), sorted.end(), Compare{});
+      build(sorted, 0, 1);
+    }
+
+    constexpr auto begin() const { return m_data.begin() + 1; }
+    constexpr auto end() const { return m_data.end(); }
+    constexpr auto cbegin() const { return m_data.cbegin() + 1; }
+    constexpr auto cend() const { return m_data.cend(); }
+
+    // the smallest value not less than v, or end()
+    template <typename K>
+    constexpr auto lower_bound(const K &v) const
+    {
+      return descend(v, [] (const T& t, const K& k) { return Compare{}(t, k); });
+    }
+
+    // the smallest value greater than v, or end()
+    template <typename K>
+    constexpr auto upper_bound(const K &v) const
+    {
+      return descend(v, [] (const T& t, const K& k) { return !Compare{}(k, t); });
+    }
+
+    template <typename K>
+    constexpr auto find(const K &v) const
+    {
+      const auto itr = lower_bound(v);
+      return itr != end() && !Compare{}(v, *itr) ? itr : end();
+    }
+
+    template <typename K>
+    constexpr bool contains(const K &v) const { return find(v) != end(); }
+
+    constexpr std::size_t size() const { return N; }
+    constexpr bool empty() const { return N == 0; }
+
+  private:
+    // an in-order walk of the tree takes the values in sorted order
+    constexpr std::size_t build(const std::array<T, N> &sorted, std::size_t i,
+                                std::size_t k)
+    {
+      if (k <= N) {
+        i = build(sorted, i, 2 * k);
+        m_data[k] = sorted[i++];
+        i = build(sorted, i, 2 * k + 1);
+      }
+      return i;
+    }
+
+    // Go left or right at every level, recording the choice in the bits of
+    // k; we went right at each node less than v. The answer is the last node
+    // where we went left, so strip the trailing right turns (ones) and that
+    // left turn (a zero) from k to get back to it.
+    template <typename K, typename Less>
+    constexpr auto descend(const K &v, Less less) const
+    {
+      std::size_t k = 1;
+      while (k <= N) {
+#if defined(__GNUC__)
+        // a cache line of descendants 4 levels down
+        if (!cx::is_constant_evaluated() && 16 * k <= N) {
+          __builtin_prefetch(m_data.data() + 16 * k);
+        }
+#endif
+        k = 2 * k + (less(m_data[k], v) ? 1 : 0);
+      }
+      while (k & 1) k >>= 1;
+      k >>= 1;
+      return k == 0 ? end() : m_data.begin() + k;
+    }
+
+    // index 0 is unused, so that the tree arithmetic starts at 1
+    std::array<T, N + 1> m_data{};
+  };
+
+  template <typename T, std::size_t N>
+  constexpr auto make_eytzinger(const T (&items)[N])
+  {
+    return eytzinger<T, N>(items);
+  }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "cx_algorithm.h"
+#include "cx_map.h"
+#include "cx_pair.h"
+#include "cx_vector.h"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cx
+{
+  // A flat_map is a map that keeps its entries sorted by key, so that lookup
+  // is a binary search rather than a linear one, and ranges of keys can be
+  // queried. Insertion has to shift the entries after the new one, so it's
+  // best suited to tables that are built once (e.g. from an initializer list)
+  // and then read many times.
+  template <typename Key, typename Value, std::size_t Size = 5,
+            typename Compare = std::less<Key>>
+  class flat_map
+  {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = cx::pair<Key, Value>;
+
+    constexpr flat_map() = default;
+
+    // where keys are repeated, the first one wins
+    constexpr flat_map(std::initializer_list<value_type> init)
+    {
+      for (const auto& v : init) insert(v);
+    }
+
+    constexpr auto begin() const { return m_data.begin(); }
+    constexpr auto begin() { return m_data.begin(); }
+
+    constexpr auto end() const { return m_data.end(); }
+    constexpr auto end() { return m_data.end(); }
+
+    constexpr auto cbegin() const { return m_data.cbegin(); }
+    constexpr auto cend() const { return m_data.cend(); }
+
+    // the first entry whose key is not less than k
+    constexpr auto lower_bound(const Key &k) { return lower_bound_impl(*this, k); }
+    constexpr auto lower_bound(const Key &k) const { return lower_bound_impl(*this, k); }
+
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto lower_bound(const K &k) { return lower_bound_impl(*this, k); }
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto lower_bound(const K &k) const { return lower_bound_impl(*this, k); }
+
+    // the first entry whose key is greater than k
+    constexpr auto upper_bound(const Key &k) { return upper_bound_impl(*this, k); }
+    constexpr auto upper_bound(const Key &k) const { return upper_bound_impl(*this, k); }
+
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto upper_bound(const K &k) { return upper_bound_impl(*this, k); }
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto upper_bound(const K &k) const { return upper_bound_impl(*this, k); }
+
+    // the range of entries whose keys lie in [first, last)
+    template <typename K>
+    constexpr auto range(const K &first, const K &last) const
+    {
+      return cx::make_pair(lower_bound(first), lower_bound(last));
+    }
+
+    constexpr auto find(const Key &k) { return find_impl(*this, k); }
+    constexpr auto find(const Key &k) const { return find_impl(*this, k); }
+
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto find(const K &k) { return find_impl(*this, k); }
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr auto find(const K &k) const { return find_impl(*this, k); }
+
+    constexpr const Value &at(const Key &k) const
+    {
+      const auto itr = find(k);
+      if (itr != end()) { return itr->second; }
+      else { throw std::range_error("Key not found"); }
+    }
+
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
+    constexpr const Value &at(const K &k) const
+    {
+      const auto itr = find(k);
+      if (itr != end()) { return itr->second; }
+      else { throw std::range_error("Key not found"); }
+    }
+
+    constexpr Value &operator[](const Key &k) {
+      return insert(value_type{k, Value{}}).first->second;
+    }
+
+    // insert an entry unless its key is already present: returns the entry
+    // with that key, and whether it was inserted
+    constexpr auto insert(const value_type &v)
+    {
+      const auto pos = static_cast<std::size_t>(lower_bound(v.first) - begin());
+      if (pos != size() && !Compare{}(v.first, m_data[pos].first)) {
+        return cx::make_pair(begin() + pos, false);
+      }
+      // grow by one, then shift the tail up to make room
+      m_data.push_back(v);
+      cx::move_backward(begin() + pos, end() - 1, end());
+      m_data[pos] = v;
+      return cx::make_pair(begin() + pos, true);
+    }
+
+    constexpr auto size() const { return m_data.size(); }
+    constexpr auto empty() const { return m_data.empty(); }
+
+  private:
+    template <typename This, typename K>
+    static constexpr auto lower_bound_impl(This &&t, const K &k)
+    {
+      return cx::lower_bound(t.begin(), t.end(), k,
+                             [] (const value_type &v, const K &key) {
+                               return Compare{}(v.first, key);
+                             });
+    }
+
+    template <typename This, typename K>
+    static constexpr auto upper_bound_impl(This &&t, const K &k)
+    {
+      return cx::upper_bound(t.begin(), t.end(), k,
+                             [] (const K &key, const value_type &v) {
+                               return Compare{}(key, v.first);
+                             });
+    }
+
+    template <typename This, typename K>
+    static constexpr auto find_impl(This &&t, const K &k)
+    {
+      const auto itr = lower_bound_impl(t, k);
+      if (itr != t.end() && !Compare{}(k, itr->first)) return itr;
+      return t.end();
+    }
+
+    // with a Size of dynamic_extent, the map can grow
+    cx::vector<value_type, Size> m_data;
+  };
+}
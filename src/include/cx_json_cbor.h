@@ -0,0 +1,442 @@
+#pragma once
+
+#include <cx_algorithm.h>
+#include <cx_config.h>
+#include <cx_iterator.h>
+#include <cx_json_parser.h>
+#include <cx_json_value.h>
+#include <cx_parser.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// CBOR (RFC 8949) decoding into, and encoding from, the same object and string
+// storage that value_recur parses JSON text into - so a value_wrapper (and
+// value_proxy) works the same whether the document arrived as text or as
+// CBOR:
+//
+//   JSON::value_wrapper<64, 1024> w;
+//   w.construct<JSON::cbor_recur>(payload);
+//   w["key"].to_Number();
+//
+// Numbers decode straight to doubles and strings are copied as they are, so
+// there is no number parsing or unescaping. CBOR items with no JSON
+// equivalent (byte strings, non-string map keys, unknown simple values) are
+// rejected. Tags are ignored, and undefined decodes as null.
+
+namespace JSON
+{
+  namespace detail
+  {
+    // the first byte of a CBOR item: the major type, and its argument (a
+    // count, a length or a value), which may follow in 1-8 bytes
+    struct cbor_head
+    {
+      unsigned major;
+      unsigned info;
+      std::uint64_t arg;
+
+      constexpr bool indefinite() const { return info == 31; }
+    };
+
+    inline constexpr unsigned char cbor_break = 0xff;
+
+    // nesting deeper than this is rejected rather than risking the stack
+    inline constexpr std::size_t cbor_max_depth = 512;
+
+    // integers up to this decode exactly as Integers (larger positive ones as
+    // Unsigned, larger negative ones as Numbers)
+    inline constexpr std::uint64_t cbor_int_max =
+      static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+    [[noreturn]] inline void cbor_malformed()
+    {
+      throw std::runtime_error("Malformed CBOR");
+    }
+
+    struct cbor_reader
+    {
+      parse_input_t in;
+
+      constexpr unsigned char peek() const
+      {
+        if (in.empty()) cbor_malformed();
+        return static_cast<unsigned char>(in[0]);
+      }
+
+      constexpr unsigned char byte()
+      {
+        const auto c = peek();
+        in.remove_prefix(1);
+        return c;
+      }
+
+      // consume a break, if that is what comes next
+      constexpr bool at_break()
+      {
+        if (peek() != cbor_break) return false;
+        in.remove_prefix(1);
+        return true;
+      }
+
+      constexpr std::uint64_t big_endian(std::size_t n)
+      {
+        std::uint64_t r = 0;
+        for (std::size_t i = 0; i < n; ++i) r = (r << 8) | byte();
+        return r;
+      }
+
+      constexpr parse_input_t take(std::uint64_t n)
+      {
+        if (n > in.size()) cbor_malformed();
+        const auto len = static_cast<std::size_t>(n);
+        const auto r = in.substr(0, len);
+        in.remove_prefix(len);
+        return r;
+      }
+
+      constexpr cbor_head head()
+      {
+        const auto b = byte();
+        cbor_head h{static_cast<unsigned>(b >> 5), static_cast<unsigned>(b & 0x1fu), 0};
+        if (h.info < 24) {
+          h.arg = h.info;
+        } else if (h.info < 28) {
+          h.arg = big_endian(std::size_t{1} << (h.info - 24));
+        } else if (h.info == 31) {
+          // only strings, arrays and maps have indefinite lengths (and a
+          // break is only allowed where we look for one)
+          if (h.major < 2 || h.major > 5) cbor_malformed();
+        } else {
+          cbor_malformed();
+        }
+        return h;
+      }
+    };
+
+    constexpr double ldexp2(double d, int e)
+    {
+      for (; e > 0; --e) d *= 2;
+      for (; e < 0; ++e) d /= 2;
+      return d;
+    }
+
+    constexpr double half_to_double(std::uint64_t h)
+    {
+      const auto exp = static_cast<int>((h >> 10) & 0x1fu);
+      const auto mant = static_cast<double>(h & 0x3ffu);
+      double d = 0;
+      if (exp == 0) {
+        d = ldexp2(mant, -24);
+      } else if (exp != 31) {
+        d = ldexp2(mant + 1024, exp - 25);
+      } else {
+        d = mant == 0 ? std::numeric_limits<double>::infinity()
+                      : std::numeric_limits<double>::quiet_NaN();
+      }
+      return (h & 0x8000u) ? -d : d;
+    }
+
+    // Count what an item needs in storage, as with sizes(): one value for
+    // everything (including object keys), plus the length of strings. This
+    // also serves to skip items.
+    constexpr Sizes cbor_measure(cbor_reader& r, std::size_t depth)
+    {
+      if (depth > cbor_max_depth) throw std::runtime_error("CBOR nesting too deep");
+      const auto h = r.head();
+      switch (h.major) {
+        case 2:
+        case 3: {
+          if (!h.indefinite()) return Sizes{1, r.take(h.arg).size()};
+          Sizes sz{1, 0};
+          while (!r.at_break()) {
+            const auto chunk = r.head();
+            if (chunk.major != h.major || chunk.indefinite()) cbor_malformed();
+            sz.string_size += r.take(chunk.arg).size();
+          }
+          return sz;
+        }
+        case 4:
+        case 5: {
+          const std::size_t per_entry = h.major == 4 ? 1 : 2;
+          Sizes sz{1, 0};
+          for (std::uint64_t i = 0; h.indefinite() ? !r.at_break() : i < h.arg; ++i) {
+            for (std::size_t j = 0; j < per_entry; ++j) {
+              sz = sz + cbor_measure(r, depth + 1);
+            }
+          }
+          return sz;
+        }
+        case 6:
+          return cbor_measure(r, depth + 1);
+        default:
+          return Sizes{1, 0};
+      }
+    }
+
+    // the number of entries in an indefinite-length array or map
+    constexpr std::uint64_t cbor_count(cbor_reader r, unsigned major, std::size_t depth)
+    {
+      std::uint64_t n = 0;
+      for (; !r.at_break(); ++n) {
+        cbor_measure(r, depth + 1);
+        if (major == 5) cbor_measure(r, depth + 1);
+      }
+      return n;
+    }
+  }
+
+  // The storage a CBOR item needs, to size a value_wrapper.
+  constexpr Sizes cbor_sizes(parse_input_t in)
+  {
+    detail::cbor_reader r{in};
+    return detail::cbor_measure(r, 0);
+  }
+
+  // Decode CBOR into storage laid out as storage_recur does: the children of
+  // an array or object are contiguous (for an object, alternating keys and
+  // values), and are allocated before any of their own children.
+  template <std::size_t = 0>
+  struct cbor_decoder
+  {
+    using V = object_storage_view;
+    using S = string_storage_view;
+
+    // decode an item into v[idx], and return the new end of the storage
+    static CX_BIT_CAST_CONSTEXPR std::size_t decode(V& v, S& s, std::size_t idx,
+                                                    std::size_t max,
+                                                    detail::cbor_reader& r,
+                                                    std::size_t depth)
+    {
+      if (depth > detail::cbor_max_depth) {
+        throw std::runtime_error("CBOR nesting too deep");
+      }
+      const auto h = r.head();
+      switch (h.major) {
+        case 0:
+          if (h.arg <= detail::cbor_int_max) {
+            v[idx].to_Int64() = static_cast<std::int64_t>(h.arg);
+          } else {
+            v[idx].to_UInt64() = h.arg;
+          }
+          return max;
+        case 1:
+          if (h.arg <= detail::cbor_int_max) {
+            v[idx].to_Int64() = -1 - static_cast<std::int64_t>(h.arg);
+          } else {
+            v[idx].to_Number() = -1.0 - static_cast<double>(h.arg);
+          }
+          return max;
+        case 3:
+          v[idx].to_String() = text(s, h, r);
+          return max;
+        case 4:
+        case 5: {
+          const auto n = h.indefinite() ? detail::cbor_count(r, h.major, depth) : h.arg;
+          const std::uint64_t per_entry = h.major == 4 ? 1 : 2;
+          if (n > (v.capacity() - max) / per_entry) {
+            throw std::range_error("Too many values for storage");
+          }
+          const auto children = static_cast<std::size_t>(n * per_entry);
+          if (h.major == 4) {
+            v[idx].to_Array() = value::ExternalView{max, children};
+          } else {
+            v[idx].to_Object() = value::ExternalView{max, children};
+          }
+          auto m = max + children;
+          for (auto i = max; i < max + children; ++i) {
+            if (h.major == 5 && (i - max) % 2 == 0) {
+              const auto key = r.head();
+              if (key.major != 3) throw std::runtime_error("CBOR map key is not a string");
+              v[i].to_String() = text(s, key, r);
+            } else {
+              m = decode(v, s, i, m, r, depth + 1);
+            }
+          }
+          if (h.indefinite() && !r.at_break()) detail::cbor_malformed();
+          return m;
+        }
+        case 6:
+          return decode(v, s, idx, max, r, depth + 1);
+        case 7:
+          switch (h.info) {
+            case 20: v[idx].to_Boolean() = false; return max;
+            case 21: v[idx].to_Boolean() = true; return max;
+            case 22:
+            case 23: v[idx].to_Null(); return max;
+            case 25: v[idx].to_Number() = detail::half_to_double(h.arg); return max;
+            case 26:
+              v[idx].to_Number() =
+                cx::bit_cast<float>(static_cast<std::uint32_t>(h.arg));
+              return max;
+            case 27: v[idx].to_Number() = cx::bit_cast<double>(h.arg); return max;
+            default: throw std::runtime_error("Unsupported CBOR simple value");
+          }
+        default:
+          throw std::runtime_error("CBOR byte strings are not supported");
+      }
+    }
+
+    // append a text string (perhaps in chunks) to the string storage
+    static constexpr value::ExternalView text(S& s, const detail::cbor_head& h,
+                                              detail::cbor_reader& r)
+    {
+      const auto offset = s.size();
+      const auto append = [&] (parse_input_t str) {
+        cx::copy(str.cbegin(), str.cend(), cx::back_insert_iterator(s));
+      };
+      if (!h.indefinite()) {
+        append(r.take(h.arg));
+      } else {
+        while (!r.at_break()) {
+          const auto chunk = r.head();
+          if (chunk.major != 3 || chunk.indefinite()) detail::cbor_malformed();
+          append(r.take(chunk.arg));
+        }
+      }
+      return value::ExternalView{offset, s.size() - offset};
+    }
+  };
+
+  // decode CBOR into fixed size storage, through cbor_decoder
+  template <std::size_t NObj, std::size_t NString>
+  struct cbor_recur
+  {
+    using V = value[NObj];
+    using S = cx::basic_string<char, NString>;
+
+    static constexpr auto value_parser(V& v, S& s,
+                                       const std::size_t& idx,
+                                       const std::size_t& max)
+    {
+      return [&] (const parse_input_t& in) {
+        return detail::with_storage_views(
+            v, s, [&] (object_storage_view& objects, string_storage_view& strings) {
+              detail::cbor_reader r{in};
+              const auto m = cbor_decoder<>::decode(objects, strings, idx, max, r, 0);
+              return parse_result_t<std::size_t>(cx::make_pair(m, r.in));
+            });
+      };
+    }
+  };
+
+  namespace detail
+  {
+    template <typename OutputIt>
+    constexpr OutputIt write_cbor_head(unsigned major, std::uint64_t arg, OutputIt out)
+    {
+      const auto first = static_cast<unsigned char>(major << 5);
+      std::size_t n = 0;
+      if (arg < 24) {
+        *out++ = static_cast<char>(first | arg);
+        return out;
+      } else if (arg <= 0xffu) {
+        *out++ = static_cast<char>(first | 24u);
+        n = 1;
+      } else if (arg <= 0xffffu) {
+        *out++ = static_cast<char>(first | 25u);
+        n = 2;
+      } else if (arg <= 0xffffffffu) {
+        *out++ = static_cast<char>(first | 26u);
+        n = 4;
+      } else {
+        *out++ = static_cast<char>(first | 27u);
+        n = 8;
+      }
+      while (n--) {
+        *out++ = static_cast<char>(static_cast<unsigned char>((arg >> (8 * n)) & 0xffu));
+      }
+      return out;
+    }
+
+    // Integral numbers are written as integers, and others in the shortest
+    // float that holds them exactly (single or double precision).
+    template <typename OutputIt>
+    CX_BIT_CAST_CONSTEXPR OutputIt write_cbor_number(double d, OutputIt out)
+    {
+      constexpr double two63 = 9223372036854775808.0;
+      const auto bits = cx::bit_cast<std::uint64_t>(d);
+      const bool negative = (bits >> 63) != 0;
+      if (d > -two63 && d < two63 && !(d == 0 && negative)
+          && static_cast<double>(static_cast<std::int64_t>(d)) == d) {
+        const auto i = static_cast<std::int64_t>(d);
+        return i >= 0 ? write_cbor_head(0, static_cast<std::uint64_t>(i), out)
+                      : write_cbor_head(1, static_cast<std::uint64_t>(-(i + 1)), out);
+      }
+      constexpr double float_max = std::numeric_limits<float>::max();
+      if (d >= -float_max && d <= float_max
+          && static_cast<double>(static_cast<float>(d)) == d) {
+        *out++ = static_cast<char>(static_cast<unsigned char>(0xfa));
+        const auto f = cx::bit_cast<std::uint32_t>(static_cast<float>(d));
+        for (int k = 3; k >= 0; --k) {
+          *out++ = static_cast<char>(static_cast<unsigned char>((f >> (8 * k)) & 0xffu));
+        }
+        return out;
+      }
+      *out++ = static_cast<char>(static_cast<unsigned char>(0xfb));
+      for (int k = 7; k >= 0; --k) {
+        *out++ = static_cast<char>(static_cast<unsigned char>((bits >> (8 * k)) & 0xffu));
+      }
+      return out;
+    }
+
+    template <typename V, typename S, typename OutputIt>
+    CX_BIT_CAST_CONSTEXPR OutputIt write_cbor_value(const V& v, const S& s,
+                                                    std::size_t idx, OutputIt out)
+    {
+      const auto val = v[idx].decode_number();
+      switch (val.type) {
+        case value::Type::Null:
+          *out++ = static_cast<char>(static_cast<unsigned char>(0xf6));
+          return out;
+        case value::Type::Boolean:
+          *out++ = static_cast<char>(static_cast<unsigned char>(val.to_Boolean() ? 0xf5 : 0xf4));
+          return out;
+        case value::Type::Number:
+          return write_cbor_number(val.to_Number(), out);
+        case value::Type::Integer: {
+          const auto i = val.to_Int64();
+          return i >= 0 ? write_cbor_head(0, static_cast<std::uint64_t>(i), out)
+                        : write_cbor_head(1, static_cast<std::uint64_t>(-(i + 1)), out);
+        }
+        case value::Type::Unsigned:
+          return write_cbor_head(0, val.to_UInt64(), out);
+        case value::Type::String: {
+          const auto& ev = val.to_String();
+          out = write_cbor_head(3, ev.extent, out);
+          for (std::size_t i = 0; i < ev.extent; ++i) *out++ = s[ev.offset + i];
+          return out;
+        }
+        case value::Type::Array: {
+          const auto& ev = val.to_Array();
+          out = write_cbor_head(4, ev.extent, out);
+          for (std::size_t i = 0; i < ev.extent; ++i) {
+            out = write_cbor_value(v, s, ev.offset + i, out);
+          }
+          return out;
+        }
+        case value::Type::Object: {
+          const auto& ev = val.to_Object();
+          out = write_cbor_head(5, ev.extent / 2, out);
+          for (std::size_t i = 0; i < ev.extent; ++i) {
+            out = write_cbor_value(v, s, ev.offset + i, out);
+          }
+          return out;
+        }
+        case value::Type::Unparsed:
+        default:
+          throw std::runtime_error("Unparsed value in CBOR");
+      }
+    }
+  }
+
+  // Write a parsed document as CBOR (as chars) to out.
+  template <std::size_t NumObjects, std::size_t StringSize, typename OutputIt>
+  CX_BIT_CAST_CONSTEXPR OutputIt write_cbor(const value_wrapper<NumObjects, StringSize>& w,
+                                            OutputIt out)
+  {
+    return detail::write_cbor_value(w.objects(), w.strings(), 0, out);
+  }
+}
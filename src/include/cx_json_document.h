@@ -0,0 +1,262 @@
+#pragma once
+
+#include <cx_config.h>
+#include <cx_json_parser.h>
+#include <cx_json_value.h>
+#include <cx_string.h>
+#include <cx_vector.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+// A mutable document: the same value storage that value_wrapper holds, but in
+// a growable node pool and string arena, so that keys can be added and
+// removed, array elements appended, and subtrees replaced:
+//
+//   JSON::document doc{R"({"a": [1, 2]})"};
+//   doc.push_back(doc.root()["a"].index, R"({"b": true})");
+//   doc.insert(0, "c", "null");
+//   doc.erase(0, "a");
+//
+// Nodes are addressed by index, which is what a proxy's index is. The
+// children of an array or object are contiguous, so an edit that grows a
+// container moves its children (but not their descendants) to the end of the
+// pool, where it can grow in place; everything else stays where it is. Moved
+// or erased nodes and strings are left behind as garbage until compact()
+// lays the document out contiguously again. Indices (and proxies) are
+// invalidated by any edit that moves the node, and by compact().
+//
+// This allocates, so it's for runtime use (or, with C++20, within a single
+// constant evaluation).
+
+namespace JSON
+{
+  class document
+  {
+  public:
+    using nodes_t = cx::vector<value, cx::dynamic_extent>;
+    using strings_t = cx::string_builder;
+
+    using proxy = value_proxy<0, nodes_t, strings_t>;
+    using const_proxy = value_proxy<0, const nodes_t, const strings_t>;
+
+    // a null document
+    constexpr document()
+    {
+      m_nodes.push_back(value{});
+      m_strings.reserve(1);
+    }
+
+    // parse a document: throws if the text isn't a single JSON value
+    constexpr explicit document(std::string_view json)
+      : document()
+    {
+      parse_into(0, json);
+    }
+
+    // copy a parsed document (decoding any raw numbers, whose text may not
+    // last)
+    template <std::size_t NumObjects, std::size_t StringSize>
+    constexpr explicit document(const value_wrapper<NumObjects, StringSize>& w)
+    {
+      m_nodes.reserve(NumObjects);
+      for (const auto& v : w.objects()) m_nodes.push_back(v.decode_number());
+      m_strings.reserve(w.strings().size() + 1);
+      for (const auto c : w.strings()) m_strings.push_back(c);
+    }
+
+    constexpr proxy root() { return proxy{0, m_nodes, m_strings}; }
+    constexpr const_proxy root() const { return const_proxy{0, m_nodes, m_strings}; }
+
+    constexpr proxy at(std::size_t idx) { return proxy{checked(idx), m_nodes, m_strings}; }
+    constexpr const_proxy at(std::size_t idx) const
+    {
+      return const_proxy{checked(idx), m_nodes, m_strings};
+    }
+
+    // replace the value at idx with the parsed text
+    constexpr void replace(std::size_t idx, std::string_view json)
+    {
+      parse_into(checked(idx), json);
+    }
+
+    // set key to the parsed text in the object at idx, adding the key if it
+    // isn't there; returns the index of the key's value
+    constexpr std::size_t insert(std::size_t idx, std::string_view key,
+                                 std::string_view json)
+    {
+      const auto existing = find(idx, key);
+      if (existing != npos) {
+        parse_into(existing, json);
+        return existing;
+      }
+      const auto slot = grow(idx, 2);
+      m_nodes[slot].to_String() = append_string(key);
+      parse_into(slot + 1, json);
+      return slot + 1;
+    }
+
+    // insert the parsed text before position pos of the array at idx;
+    // returns the index of the new element
+    constexpr std::size_t insert(std::size_t idx, std::size_t pos,
+                                 std::string_view json)
+    {
+      if (pos > m_nodes[checked(idx)].array_Size()) {
+        throw std::range_error("Index past end of array");
+      }
+      const auto slot = grow(idx, 1);
+      const auto ext = m_nodes[idx].to_Array();
+      for (auto i = slot; i > ext.offset + pos; --i) m_nodes[i] = m_nodes[i-1];
+      m_nodes[ext.offset + pos] = value{};
+      parse_into(ext.offset + pos, json);
+      return ext.offset + pos;
+    }
+
+    // append the parsed text to the array at idx; returns the index of the
+    // new element
+    constexpr std::size_t push_back(std::size_t idx, std::string_view json)
+    {
+      const auto slot = grow(idx, 1);
+      parse_into(slot, json);
+      return slot;
+    }
+
+    // remove key from the object at idx; returns whether it was there
+    constexpr bool erase(std::size_t idx, std::string_view key)
+    {
+      const auto i = find(idx, key);
+      if (i == npos) return false;
+      auto& ext = m_nodes[idx].to_Object();
+      for (auto j = i - 1; j + 2 < ext.offset + ext.extent; ++j) m_nodes[j] = m_nodes[j+2];
+      ext.extent -= 2;
+      return true;
+    }
+
+    // remove position pos from the array at idx
+    constexpr void erase(std::size_t idx, std::size_t pos)
+    {
+      m_nodes[checked(idx)].assert_type(value::Type::Array);
+      auto& ext = m_nodes[idx].to_Array();
+      if (pos >= ext.extent) throw std::range_error("Index past end of array");
+      for (auto j = ext.offset + pos; j + 1 < ext.offset + ext.extent; ++j) {
+        m_nodes[j] = m_nodes[j+1];
+      }
+      --ext.extent;
+    }
+
+    // Lay the document out again with no garbage: breadth first, with the
+    // children of each container contiguous, and strings in the same order.
+    CX_CONSTEXPR20 void compact()
+    {
+      nodes_t nodes;
+      nodes.reserve(m_nodes.size());
+      strings_t strings;
+      strings.reserve(m_strings.size() + 1);
+      nodes.push_back(m_nodes[0]);
+      for (std::size_t i = 0; i < nodes.size(); ++i) {
+        auto v = nodes[i];
+        if (v.type == value::Type::String) {
+          const auto ext = v.to_String();
+          const auto offset = strings.size();
+          for (std::size_t j = 0; j < ext.extent; ++j) {
+            strings.push_back(m_strings[ext.offset + j]);
+          }
+          v.to_String() = value::ExternalView{offset, ext.extent};
+        } else if (v.type == value::Type::Array || v.type == value::Type::Object) {
+          auto& ext = v.data.external;
+          const auto offset = nodes.size();
+          for (std::size_t j = 0; j < ext.extent; ++j) {
+            nodes.push_back(m_nodes[ext.offset + j]);
+          }
+          ext.offset = offset;
+        }
+        nodes[i] = v;
+      }
+      m_nodes = std::move(nodes);
+      m_strings = std::move(strings);
+    }
+
+    // the storage, including any garbage
+    constexpr std::size_t num_objects() const { return m_nodes.size(); }
+    constexpr std::size_t string_size() const { return m_strings.size(); }
+    constexpr const nodes_t& objects() const { return m_nodes; }
+    constexpr const strings_t& strings() const { return m_strings; }
+
+  private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    constexpr std::size_t checked(std::size_t idx) const
+    {
+      if (idx >= m_nodes.size()) throw std::range_error("Index past end of document");
+      return idx;
+    }
+
+    // the index of key's value in the object at idx, or npos
+    constexpr std::size_t find(std::size_t idx, std::string_view key) const
+    {
+      const auto& ext = m_nodes[checked(idx)].to_Object();
+      for (auto i = ext.offset; i < ext.offset + ext.extent; i += 2) {
+        const auto& k = m_nodes[i].to_String();
+        if (cx::equal(key.cbegin(), key.cend(), m_strings.cbegin() + k.offset,
+                      m_strings.cbegin() + k.offset + k.extent)) {
+          return i + 1;
+        }
+      }
+      return npos;
+    }
+
+    // add n (null) children to the end of the container at idx, returning the
+    // index of the first
+    constexpr std::size_t grow(std::size_t idx, std::size_t n)
+    {
+      auto& v = m_nodes[checked(idx)];
+      if (v.type != value::Type::Array) v.assert_type(value::Type::Object);
+      auto ext = v.data.external;
+      const auto end = m_nodes.size();
+      if (ext.offset + ext.extent != end) {
+        // move the children to the end of the pool, where they can grow
+        for (std::size_t j = 0; j < ext.extent; ++j) {
+          m_nodes.push_back(m_nodes[ext.offset + j]);
+        }
+        ext.offset = end;
+      }
+      for (std::size_t j = 0; j < n; ++j) m_nodes.push_back(value{});
+      ext.extent += n;
+      m_nodes[idx].data.external = ext;
+      return ext.offset + ext.extent - n;
+    }
+
+    constexpr value::ExternalView append_string(std::string_view s)
+    {
+      const auto offset = m_strings.size();
+      for (const auto c : s) m_strings.push_back(c);
+      return value::ExternalView{offset, s.size()};
+    }
+
+    // parse text into the node at idx, with its descendants at the end of
+    // the pool
+    constexpr void parse_into(std::size_t idx, std::string_view json)
+    {
+      const auto sz = sizes_parser()(json);
+      if (!sz || !skip_whitespace()(sz->second)->second.empty()) {
+        throw std::runtime_error("Invalid JSON");
+      }
+      const auto max = m_nodes.size();
+      const auto num_nodes = max + sz->first.num_objects - 1;
+      const auto num_strings = m_strings.size() + sz->first.string_size;
+      m_nodes.resize_and_overwrite(num_nodes, [&] (value* vp, std::size_t n) {
+        m_strings.resize_and_overwrite(num_strings, [&] (char* sp, std::size_t m) {
+          object_storage_view objects{vp, n};
+          string_storage_view strings{sp, m_strings.size(), m};
+          storage_recur<>::value_parser(objects, strings, idx, max)(json);
+          return strings.size();
+        });
+        return n;
+      });
+    }
+
+    nodes_t m_nodes;
+    strings_t m_strings;
+  };
+}
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <cx_config.h>
+#include <cx_json_parser.h>
+#include <cx_json_value.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CX_JSON_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CX_JSON_HAS_MMAP 0
+#endif
+
+// A flat image of a parsed document, for shipping large documents as files
+// and loading them without parsing. Values already refer to each other by
+// index into the object storage, and to strings by offset into the string
+// storage, so the image is just those two arrays behind a header - it can be
+// mapped anywhere, shared read-only between processes, and read in place.
+//
+// The layout (all integers little-endian):
+//
+//   header  "cxjsonim", u32 version, u32 node size, u64 nodes, u64 string size
+//   nodes   u8 type, 7 bytes zero, u64 offset (or number bits, integer,
+//           or boolean), u64 extent
+//   strings the string storage bytes
+//
+// Any trailing bytes are ignored. Reading validates offsets as it goes, so a
+// corrupt image throws rather than reading out of bounds.
+
+namespace JSON
+{
+  inline constexpr std::uint32_t image_version = 1;
+  inline constexpr std::size_t image_header_size = 32;
+  inline constexpr std::size_t image_node_size = 24;
+
+  namespace detail
+  {
+    inline constexpr char image_magic[] = "cxjsonim";
+
+    constexpr std::uint64_t read_u64(const char* p)
+    {
+      std::uint64_t r = 0;
+      for (int i = 7; i >= 0; --i) {
+        r = (r << 8) | static_cast<unsigned char>(p[i]);
+      }
+      return r;
+    }
+
+    constexpr std::uint32_t read_u32(const char* p)
+    {
+      std::uint32_t r = 0;
+      for (int i = 3; i >= 0; --i) {
+        r = (r << 8) | static_cast<unsigned char>(p[i]);
+      }
+      return r;
+    }
+
+    template <typename OutputIt>
+    constexpr OutputIt write_le(std::uint64_t v, std::size_t bytes, OutputIt out)
+    {
+      for (std::size_t i = 0; i < bytes; ++i, v >>= 8) {
+        *out++ = static_cast<char>(static_cast<unsigned char>(v & 0xffu));
+      }
+      return out;
+    }
+  }
+
+  template <std::size_t NumObjects, std::size_t StringSize>
+  constexpr std::size_t image_size(const value_wrapper<NumObjects, StringSize>& w)
+  {
+    return image_header_size + image_node_size * NumObjects + w.strings().size();
+  }
+
+  // Write the image of a parsed document as chars to out. Every value must
+  // have been parsed.
+  template <std::size_t NumObjects, std::size_t StringSize, typename OutputIt>
+  CX_BIT_CAST_CONSTEXPR OutputIt write_image(const value_wrapper<NumObjects, StringSize>& w,
+                                             OutputIt out)
+  {
+    for (std::size_t i = 0; i < 8; ++i) {
+      *out++ = detail::image_magic[i];
+    }
+    out = detail::write_le(image_version, 4, out);
+    out = detail::write_le(image_node_size, 4, out);
+    out = detail::write_le(NumObjects, 8, out);
+    out = detail::write_le(w.strings().size(), 8, out);
+
+    for (const auto& node : w.objects()) {
+      // raw numbers refer to the input, so they are stored decoded
+      const auto v = node.decode_number();
+      std::uint64_t a = 0;
+      std::uint64_t b = 0;
+      switch (v.type) {
+        case value::Type::Unparsed:
+          throw std::runtime_error("Unparsed value in image");
+        case value::Type::String:
+        case value::Type::Array:
+        case value::Type::Object:
+          a = v.data.external.offset;
+          b = v.data.external.extent;
+          break;
+        case value::Type::Number:
+          a = cx::bit_cast<std::uint64_t>(v.data.number);
+          break;
+        case value::Type::Integer:
+          a = static_cast<std::uint64_t>(v.data.integer);
+          break;
+        case value::Type::Unsigned:
+          a = v.data.uinteger;
+          break;
+        case value::Type::Boolean:
+          a = v.data.boolean ? 1 : 0;
+          break;
+        case value::Type::Null:
+        default:
+          break;
+      }
+      out = detail::write_le(static_cast<std::uint64_t>(v.type), 8, out);
+      out = detail::write_le(a, 8, out);
+      out = detail::write_le(b, 8, out);
+    }
+
+    for (auto c : w.strings()) {
+      *out++ = c;
+    }
+    return out;
+  }
+
+  // The image of a document known at compile time, padded to its string
+  // capacity.
+  template <std::size_t NumObjects, std::size_t StringSize>
+  CX_BIT_CAST_CONSTEXPR auto make_image(const value_wrapper<NumObjects, StringSize>& w)
+  {
+    std::array<char,
+               image_header_size + image_node_size * NumObjects + StringSize> img{};
+    write_image(w, img.begin());
+    return img;
+  }
+
+  // A node of an image, read in place. This provides what value_proxy needs
+  // of a value.
+  class image_node
+  {
+  public:
+    constexpr image_node(const char* p, std::size_t num_nodes,
+                         std::size_t string_size)
+      : m_p(p), m_num_nodes(num_nodes), m_string_size(string_size)
+    {}
+
+    constexpr value::Type type() const
+    {
+      return static_cast<value::Type>(static_cast<unsigned char>(m_p[0]));
+    }
+
+    constexpr void assert_type(value::Type t) const
+    {
+      if (type() != t) throw std::runtime_error("Incorrect type");
+    }
+
+    constexpr bool is_Null() const { return type() == value::Type::Null; }
+
+    constexpr value::ExternalView to_Object() const
+    {
+      assert_type(value::Type::Object);
+      return external(m_num_nodes);
+    }
+    constexpr auto object_Size() const { return to_Object().extent / 2; }
+
+    constexpr value::ExternalView to_Array() const
+    {
+      assert_type(value::Type::Array);
+      return external(m_num_nodes);
+    }
+    constexpr auto array_Size() const { return to_Array().extent; }
+
+    constexpr value::ExternalView to_String() const
+    {
+      assert_type(value::Type::String);
+      return external(m_string_size);
+    }
+    constexpr auto string_Size() const { return to_String().extent; }
+
+    // numbers convert as a value's do
+    CX_BIT_CAST_CONSTEXPR double to_Number() const { return number().to_Number(); }
+    CX_BIT_CAST_CONSTEXPR std::int64_t to_Int64() const { return number().to_Int64(); }
+    CX_BIT_CAST_CONSTEXPR std::uint64_t to_UInt64() const { return number().to_UInt64(); }
+
+    constexpr bool to_Boolean() const
+    {
+      assert_type(value::Type::Boolean);
+      return detail::read_u64(m_p + 8) != 0;
+    }
+
+  private:
+    CX_BIT_CAST_CONSTEXPR value number() const
+    {
+      const auto bits = detail::read_u64(m_p + 8);
+      switch (type()) {
+        case value::Type::Number:
+          return value{value::Type::Number, value::Data(cx::bit_cast<double>(bits))};
+        case value::Type::Integer:
+          return value{value::Type::Integer, value::Data(static_cast<std::int64_t>(bits))};
+        case value::Type::Unsigned:
+          return value{value::Type::Unsigned, value::Data(bits)};
+        default:
+          throw std::runtime_error("Incorrect type");
+      }
+    }
+
+    constexpr value::ExternalView external(std::size_t limit) const
+    {
+      const auto extent = detail::read_u64(m_p + 16);
+      // an empty string's offset is irrelevant (and may be anything)
+      const auto offset = extent == 0 ? 0 : detail::read_u64(m_p + 8);
+      if (offset > limit || extent > limit - offset) {
+        throw std::runtime_error("Corrupt image");
+      }
+      return value::ExternalView{static_cast<std::size_t>(offset),
+                                 static_cast<std::size_t>(extent)};
+    }
+
+    const char* m_p;
+    std::size_t m_num_nodes;
+    std::size_t m_string_size;
+  };
+
+  // the object storage and string storage of an image, for value_proxy
+  class image_nodes
+  {
+  public:
+    constexpr image_nodes(const char* p, std::size_t num_nodes,
+                          std::size_t string_size)
+      : m_p(p), m_num_nodes(num_nodes), m_string_size(string_size)
+    {}
+
+    constexpr image_node operator[](std::size_t i) const
+    {
+      if (i >= m_num_nodes) throw std::runtime_error("Corrupt image");
+      return image_node{m_p + i * image_node_size, m_num_nodes, m_string_size};
+    }
+
+    constexpr std::size_t size() const { return m_num_nodes; }
+
+  private:
+    const char* m_p;
+    std::size_t m_num_nodes;
+    std::size_t m_string_size;
+  };
+
+  class image_strings
+  {
+  public:
+    constexpr image_strings(const char* p, std::size_t size)
+      : m_p(p), m_size(size)
+    {}
+
+    // one past the end is allowed, for the offset of an empty string
+    constexpr const char& operator[](std::size_t i) const
+    {
+      if (i > m_size) throw std::runtime_error("Corrupt image");
+      return m_p[i];
+    }
+
+    constexpr std::size_t size() const { return m_size; }
+
+  private:
+    const char* m_p;
+    std::size_t m_size;
+  };
+
+  using image_proxy = value_proxy<0, const image_nodes, const image_strings>;
+
+  // A view of an image in memory: checking the header is all the work done
+  // up front. The bytes must outlive the view, and the view must outlive the
+  // proxies it hands out.
+  class image_view
+  {
+  public:
+    constexpr image_view(const char* data, std::size_t size)
+      : image_view(data, read_header(data, size))
+    {}
+
+    constexpr image_proxy root() const
+    {
+      return image_proxy{0, m_nodes, m_strings};
+    }
+
+    constexpr const image_nodes& nodes() const { return m_nodes; }
+    constexpr const image_strings& strings() const { return m_strings; }
+
+  private:
+    struct header
+    {
+      std::size_t num_nodes;
+      std::size_t string_size;
+    };
+
+    constexpr image_view(const char* data, const header& h)
+      : m_nodes(data + image_header_size, h.num_nodes, h.string_size),
+        m_strings(data + image_header_size + h.num_nodes * image_node_size,
+                  h.string_size)
+    {}
+
+    static constexpr header read_header(const char* data, std::size_t size)
+    {
+      if (size < image_header_size) throw std::runtime_error("Truncated image");
+      for (std::size_t i = 0; i < 8; ++i) {
+        if (data[i] != detail::image_magic[i]) {
+          throw std::runtime_error("Not a JSON image");
+        }
+      }
+      if (detail::read_u32(data + 8) != image_version) {
+        throw std::runtime_error("Unsupported JSON image version");
+      }
+      if (detail::read_u32(data + 12) != image_node_size) {
+        throw std::runtime_error("Unsupported JSON image node size");
+      }
+      const auto n = detail::read_u64(data + 16);
+      if (n == 0 || n > (size - image_header_size) / image_node_size) {
+        throw std::runtime_error("Truncated image");
+      }
+      const auto string_size = detail::read_u64(data + 24);
+      if (string_size > size - image_header_size - n * image_node_size) {
+        throw std::runtime_error("Truncated image");
+      }
+      return header{static_cast<std::size_t>(n), static_cast<std::size_t>(string_size)};
+    }
+
+    image_nodes m_nodes;
+    image_strings m_strings;
+  };
+
+#if CX_JSON_HAS_MMAP
+  // An image file mapped read-only into memory: startup costs one mmap, pages
+  // are read on first touch, and they are shared through the page cache with
+  // every other process mapping the same file. Proxies from root() refer to
+  // this object, so it can be neither copied nor moved.
+  class mapped_image
+  {
+  public:
+    explicit mapped_image(const char* path)
+    {
+      const int fd = ::open(path, O_RDONLY);
+      if (fd < 0) throw std::runtime_error("Cannot open JSON image");
+      struct stat st;
+      if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read JSON image");
+      }
+      m_size = static_cast<std::size_t>(st.st_size);
+      m_addr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (m_addr == MAP_FAILED) throw std::runtime_error("Cannot map JSON image");
+      try {
+        m_view = image_view{static_cast<const char*>(m_addr), m_size};
+      } catch (...) {
+        ::munmap(m_addr, m_size);
+        throw;
+      }
+    }
+
+    mapped_image(const mapped_image&) = delete;
+    mapped_image& operator=(const mapped_image&) = delete;
+
+    ~mapped_image() { ::munmap(m_addr, m_size); }
+
+    image_proxy root() const { return m_view->root(); }
+    const image_view& view() const { return *m_view; }
+
+  private:
+    void* m_addr = nullptr;
+    std::size_t m_size = 0;
+    std::optional<image_view> m_view;
+  };
+#endif
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+// The lexical side of JSON numbers: finding the extent of a number in the
+// text and converting its digits. This needs neither parsers nor values, so
+// that both the number parsers (cx_json_parser.h) and values holding raw
+// numbers (cx_json_value.h), which decode them on access, can share it.
+
+namespace JSON
+{
+  namespace detail
+  {
+    constexpr std::size_t count_digits(std::string_view s)
+    {
+      std::size_t n = 0;
+      while (n < s.size() && s[n] >= '0' && s[n] <= '9') ++n;
+      return n;
+    }
+
+    // the integral digits of a JSON number are a 0, or digits that don't
+    // begin with 0
+    constexpr std::size_t count_integral_digits(std::string_view s)
+    {
+      const auto n = count_digits(s);
+      return n != 0 && s[0] == '0' ? 1 : n;
+    }
+
+    // the parts of a number, as digits
+    struct number_parts
+    {
+      std::size_t size = 0;   // the extent of the number: 0 if there isn't one
+      bool negative = false;
+      std::string_view integral;
+      std::string_view fraction;
+      bool negative_exponent = false;
+      std::string_view exponent;
+    };
+
+    // Scan the number at the start of s. The fraction and exponent are
+    // optional, so that e.g. "1." scans as 1 and leaves the "." (as the
+    // number parser does).
+    constexpr number_parts scan_number(std::string_view s)
+    {
+      number_parts p{};
+      std::size_t i = 0;
+      if (i < s.size() && s[i] == '-') {
+        p.negative = true;
+        ++i;
+      }
+      const auto n = count_integral_digits(s.substr(i));
+      if (n == 0) return number_parts{};
+      p.integral = s.substr(i, n);
+      i += n;
+
+      if (i < s.size() && s[i] == '.') {
+        const auto f = count_digits(s.substr(i + 1));
+        if (f != 0) {
+          p.fraction = s.substr(i + 1, f);
+          i += 1 + f;
+        }
+      }
+
+      if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        auto j = i + 1;
+        bool negative = false;
+        if (j < s.size() && (s[j] == '+' || s[j] == '-')) {
+          negative = s[j] == '-';
+          ++j;
+        }
+        const auto e = count_digits(s.substr(j));
+        if (e != 0) {
+          p.negative_exponent = negative;
+          p.exponent = s.substr(j, e);
+          i = j + e;
+        }
+      }
+
+      p.size = i;
+      return p;
+    }
+
+    // The digits are accumulated in doubles (and the exponent is clamped), so
+    // that long numbers lose precision rather than overflowing.
+
+    constexpr double integral_to_double(std::string_view digits)
+    {
+      double d = 0;
+      for (const auto c : digits) d = d * 10 + (c - '0');
+      return d;
+    }
+
+    constexpr double fraction_to_double(std::string_view digits)
+    {
+      double d = 0;
+      for (auto n = digits.size(); n > 0; --n) {
+        d += digits[n-1] - '0';
+        d /= 10;
+      }
+      return d;
+    }
+
+    constexpr int exponent_to_int(std::string_view digits, bool negative)
+    {
+      // beyond this, every double over/underflows
+      constexpr int max_exp = 10000;
+      int j = 0;
+      for (const auto c : digits) {
+        j = j < max_exp ? j * 10 + (c - '0') : max_exp;
+      }
+      return negative ? -j : j;
+    }
+
+    constexpr double scale10(double mantissa, int exp)
+    {
+      if (exp > 0) {
+        while (exp--) {
+          mantissa *= 10;
+        }
+      } else {
+        while (exp++) {
+          mantissa /= 10;
+        }
+      }
+      return mantissa;
+    }
+
+    constexpr double to_double(const number_parts& p)
+    {
+      const auto m = integral_to_double(p.integral) + fraction_to_double(p.fraction);
+      return scale10(p.negative ? -m : m, exponent_to_int(p.exponent, p.negative_exponent));
+    }
+
+    // the value of integral digits, if it fits in 64 bits
+    constexpr bool integer_magnitude(std::string_view digits, std::uint64_t& m)
+    {
+      constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+      m = 0;
+      for (const auto c : digits) {
+        const auto d = static_cast<std::uint64_t>(c - '0');
+        if (m > (max - d) / 10) return false;
+        m = m * 10 + d;
+      }
+      return true;
+    }
+  }
+}
@@ -2,14 +2,20 @@
 
 #include <cx_algorithm.h>
 #include <cx_iterator.h>
+#include <cx_json_number.h>
 #include <cx_json_value.h>
 #include <cx_parser.h>
 #include <cx_string.h>
+#include <cx_utf8.h>
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <limits>
+#include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 namespace JSON
@@ -40,53 +46,98 @@ namespace JSON
                 make_string_parser("null"sv));
   }
 
+  // parse a run of decimal digits, as the string_view of them
+  constexpr auto digits_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<std::string_view> {
+      const auto n = detail::count_digits(s);
+      if (n == 0) return std::nullopt;
+      return parse_result_t<std::string_view>(cx::make_pair(s.substr(0, n), s.substr(n)));
+    };
+  }
+
+  // parse the integral digits of a JSON number: a 0, or digits that don't
+  // begin with 0
+  constexpr auto integral_digits_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<std::string_view> {
+      const auto n = detail::count_integral_digits(s);
+      if (n == 0) return std::nullopt;
+      return parse_result_t<std::string_view>(cx::make_pair(s.substr(0, n), s.substr(n)));
+    };
+  }
+
   // parse a JSON number
 
+  // The arithmetic is shared with raw numbers (see cx_json_number.h), which
+  // decode to the same doubles; integer_parser below keeps integers exact.
   constexpr auto number_parser()
   {
     constexpr auto neg_parser = option('+', make_char_parser('-'));
     constexpr auto integral_parser =
-      combine(neg_parser,
-              fmap([] (char) { return 0; }, make_char_parser('0')) | int1_parser(),
-              [] (char sign, int i) { return sign == '+' ? i : -i; });
-
-    constexpr auto frac_parser = make_char_parser('.') < int0_parser();
-
-    constexpr auto mantissa_parser = combine(
-        integral_parser, option(0, frac_parser),
-        [] (int i, int f) -> double {
-          double d = 0;
-          while (f > 0) {
-            d += f % 10;
-            d /= 10;
-            f /= 10;
-          }
-          return i + d;
+      fmap(detail::integral_to_double, integral_digits_parser());
+
+    constexpr auto frac_parser = make_char_parser('.') < digits_parser();
+
+    constexpr auto unsigned_mantissa_parser = combine(
+        integral_parser, option(std::string_view{}, frac_parser),
+        [] (double i, std::string_view f) {
+          return i + detail::fraction_to_double(f);
         });
 
+    constexpr auto mantissa_parser =
+      combine(neg_parser, unsigned_mantissa_parser,
+              [] (char sign, double m) { return sign == '+' ? m : -m; });
+
     constexpr auto e_parser = make_char_parser('e') | make_char_parser('E');
     constexpr auto sign_parser = make_char_parser('+') | neg_parser;
     constexpr auto exponent_parser =
       bind(e_parser < sign_parser,
            [] (const char sign, const auto& sv) {
-             return fmap([sign] (int j) { return sign == '+' ? j : -j; },
-                         int0_parser())(sv);
+             return fmap([sign] (std::string_view digits) {
+                           return detail::exponent_to_int(digits, sign == '-');
+                         },
+                         digits_parser())(sv);
            });
 
-    return combine(
-        mantissa_parser, option(0, exponent_parser),
-        [] (double mantissa, int exp) {
-          if (exp > 0) {
-            while (exp--) {
-              mantissa *= 10;
-            }
-          } else {
-            while (exp++) {
-              mantissa /= 10;
-            }
-          }
-          return mantissa;
-        });
+    return combine(mantissa_parser, option(0, exponent_parser), detail::scale10);
+  }
+
+  // parse the extent of a JSON number, without decoding it
+  constexpr auto number_extent_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<std::string_view> {
+      const auto p = detail::scan_number(s);
+      if (p.size == 0) return std::nullopt;
+      return parse_result_t<std::string_view>(
+          cx::make_pair(s.substr(0, p.size), s.substr(p.size)));
+    };
+  }
+
+  // parse a JSON number as a value: exactly, without touching floating point,
+  // if it's an integer that fits in 64 bits (an Integer, or Unsigned if it's
+  // too big for an int64), and as a double otherwise
+  constexpr auto number_value_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<value> {
+      const auto p = detail::scan_number(s);
+      if (p.size == 0) return std::nullopt;
+      return parse_result_t<value>(cx::make_pair(value::from_number(p), s.substr(p.size)));
+    };
+  }
+
+  // parse a JSON number that is such an integer
+  constexpr auto integer_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<value> {
+      auto r = number_value_parser()(s);
+      if (!r || r->first.type == value::Type::Number) return std::nullopt;
+      const auto rest = r->second;
+      if (!rest.empty() && (rest[0] == '.' || rest[0] == 'e' || rest[0] == 'E')) {
+        return std::nullopt;
+      }
+      return r;
+    };
   }
 
   // ---------------------------------------------------------------------------
@@ -138,26 +189,61 @@ namespace JSON
     return s;
   }
 
-  constexpr auto to_hex(char c)
+  namespace detail
   {
-    if (c >= '0' && c <= '9') return static_cast<uint16_t>(c - '0');
-    if (c >= 'a' && c <= 'f') return static_cast<uint16_t>(c - 'a' + 10);
-    return static_cast<uint16_t>(c - 'A' + 10);
+    // the value of each hex digit, and 0xff for anything else
+    constexpr std::array<unsigned char, 256> make_hex_digits()
+    {
+      std::array<unsigned char, 256> t{};
+      for (std::size_t c = 0; c < 256; ++c) {
+        t[c] = c >= '0' && c <= '9' ? static_cast<unsigned char>(c - '0')
+          : c >= 'a' && c <= 'f' ? static_cast<unsigned char>(c - 'a' + 10)
+          : c >= 'A' && c <= 'F' ? static_cast<unsigned char>(c - 'A' + 10)
+          : 0xff;
+      }
+      return t;
+    }
+
+    inline constexpr auto hex_digits = make_hex_digits();
+
+    // the value of the four hex digits at p, or something past 0xffff if
+    // they aren't all hex digits
+    constexpr std::uint32_t hex4(const char* p)
+    {
+      const std::uint32_t a = hex_digits[static_cast<unsigned char>(p[0])];
+      const std::uint32_t b = hex_digits[static_cast<unsigned char>(p[1])];
+      const std::uint32_t c = hex_digits[static_cast<unsigned char>(p[2])];
+      const std::uint32_t d = hex_digits[static_cast<unsigned char>(p[3])];
+      return (a | b | c | d) > 0xf ? 0x10000 : a << 12 | b << 8 | c << 4 | d;
+    }
+  }
+
+  // parse a \u escape as a code point. A UTF-16 surrogate pair (two escapes)
+  // is one code point; a lone surrogate, which has no UTF-8 encoding, comes
+  // out as U+FFFD (the replacement character). Both the string parsers and
+  // the string size parsers use this, so that they agree on the size.
+  constexpr auto unicode_escape_parser()
+  {
+    return [] (parse_input_t s) -> parse_result_t<std::uint32_t> {
+      using R = parse_result_t<std::uint32_t>;
+      if (s.size() < 6 || s[0] != '\\' || s[1] != 'u') return std::nullopt;
+      const auto hi = detail::hex4(s.data() + 2);
+      if (hi > 0xffff) return std::nullopt;
+      if (hi < 0xd800 || hi > 0xdfff) return R(cx::make_pair(hi, drop(s, 6)));
+      if (hi <= 0xdbff && s.size() >= 12 && s[6] == '\\' && s[7] == 'u') {
+        const auto lo = detail::hex4(s.data() + 8);
+        if (lo >= 0xdc00 && lo <= 0xdfff) {
+          return R(cx::make_pair(0x10000 + ((hi - 0xd800) << 10) + (lo - 0xdc00),
+                                 drop(s, 12)));
+        }
+      }
+      return R(cx::make_pair(std::uint32_t{0xfffd}, drop(s, 6)));
+    };
   }
 
   constexpr auto unicode_point_parser()
   {
-    using namespace std::literals;
-    constexpr auto p =
-      make_char_parser('\\') <
-      make_char_parser('u') <
-      exactly_n(
-          one_of("0123456789abcdefABCDEF"sv),
-          4, 0u,
-          [] (uint16_t hexcode, char c) -> uint16_t {
-            return (hexcode << 4) + to_hex(c);
-          });
-    return fmap(to_utf8, p);
+    return fmap(to_utf8, unicode_escape_parser());
   }
 
   constexpr auto string_char_parser()
@@ -186,18 +272,20 @@ namespace JSON
 
   // parse a JSON string
 
-  // See the comment about the char parsers above. Here we accumulate a
-  // cx::string<> (which is arbitrarily sized at 32).
+  // See the comment about the char parsers above. Here we accumulate a string
+  // in place so that it isn't copied for every char. By default that's a
+  // cx::string (which is arbitrarily sized at 32); pass a cx::string_builder
+  // (with C++20) for strings of any length, or a larger cx::basic_string.
 
+  template <typename String = cx::string>
   constexpr auto string_parser()
   {
     constexpr auto quote_parser = make_char_parser('"');
-    constexpr auto str_parser =
+    const auto str_parser =
       many(string_char_parser(),
-           cx::string{},
-           [] (auto acc, const auto& str) {
+           String{},
+           [] (String& acc, const auto& str) {
              cx::copy(str.cbegin(), str.cend(), cx::back_insert_iterator(acc));
-             return acc;
            });
     return quote_parser < str_parser > quote_parser;
   }
@@ -219,17 +307,7 @@ namespace JSON
 
   constexpr auto unicode_point_count_parser()
   {
-    using namespace std::literals;
-    constexpr auto p =
-      make_char_parser('\\') <
-      make_char_parser('u') <
-      exactly_n(
-          one_of("0123456789abcdefABCDEF"sv),
-          4, 0u,
-          [] (uint16_t hexcode, char c) -> uint16_t {
-            return (hexcode << 4) + to_hex(c);
-          });
-    return fmap(to_utf8_count, p);
+    return fmap(to_utf8_count, unicode_escape_parser());
   }
 
   constexpr auto string_char_count_parser()
@@ -299,16 +377,16 @@ namespace JSON
     {
       using namespace std::literals;
       return [] (const auto& sv) -> parse_result_t<Sizes> {
-        constexpr auto p =
-          fmap([] (auto) { return Sizes{1, 0}; },
-               make_string_parser("true"sv) | make_string_parser("false"sv)
-               | make_string_parser("null"sv))
-          | fmap([] (auto) { return Sizes{1, 0}; },
-                 number_parser())
-          | fmap([] (std::size_t len) { return Sizes{1, len}; },
-                 string_size_parser())
-          | array_parser()
-          | object_parser();
+        constexpr auto literal = [] (auto) { return Sizes{1, 0}; };
+        constexpr auto p = dispatch(
+            arm("t"sv, fmap(literal, make_string_parser("true"sv))),
+            arm("f"sv, fmap(literal, make_string_parser("false"sv))),
+            arm("n"sv, fmap(literal, make_string_parser("null"sv))),
+            arm("-0123456789"sv, fmap(literal, number_extent_parser())),
+            arm("\""sv, fmap([] (std::size_t len) { return Sizes{1, len}; },
+                             string_size_parser())),
+            arm("["sv, array_parser()),
+            arm("{"sv, object_parser()));
         return (skip_whitespace() < p)(sv);
       };
     }
@@ -358,11 +436,16 @@ namespace JSON
   // provide the sizes parser outside the struct qualification
   constexpr auto sizes_parser = sizes_recur<>::value_parser;
 
+  constexpr auto sizes(std::string_view sv)
+  {
+    return sizes_parser()(sv)->first;
+  }
+
   template <char... Cs>
   constexpr auto sizes()
   {
     std::initializer_list<char> il{Cs...};
-    return sizes_parser()(std::string_view(il.begin(), il.size()))->first;
+    return sizes(std::string_view(il.begin(), il.size()));
   }
 
   //----------------------------------------------------------------------------
@@ -384,16 +467,15 @@ namespace JSON
       using namespace std::literals;
       using R = parse_result_t<std::string_view>;
       return [] (const auto& sv) -> R {
-        constexpr auto p =
-          fmap([] (auto) { return std::monostate{}; },
-               make_string_parser("true"sv) | make_string_parser("false"sv)
-               | make_string_parser("null"sv))
-          | fmap([] (auto) { return std::monostate{}; },
-                 number_parser())
-          | fmap([] (auto) { return std::monostate{}; },
-                 string_size_parser())
-          | array_parser()
-          | object_parser();
+        constexpr auto skip = [] (auto) { return std::monostate{}; };
+        constexpr auto p = dispatch(
+            arm("t"sv, fmap(skip, make_string_parser("true"sv))),
+            arm("f"sv, fmap(skip, make_string_parser("false"sv))),
+            arm("n"sv, fmap(skip, make_string_parser("null"sv))),
+            arm("-0123456789"sv, fmap(skip, number_extent_parser())),
+            arm("\""sv, fmap(skip, string_size_parser())),
+            arm("["sv, array_parser()),
+            arm("{"sv, object_parser()));
         auto r = (skip_whitespace() < p)(sv);
         if (!r) return std::nullopt;
         std::size_t len = static_cast<std::size_t>(r->second.data() - sv.data());
@@ -437,14 +519,99 @@ namespace JSON
   //----------------------------------------------------------------------------
   // JSON parser
 
-  // parse into a vector
-  // return the past-the-end index into the vector resulting from parsing
+  // The parser works on views of the storage, which erase its capacity: so
+  // the grammar below is instantiated once, rather than once for every size of
+  // document. Only value_recur (and value_wrapper) depend on the sizes.
 
-  template <std::size_t NObj, std::size_t NString>
-  struct value_recur
+  // the value storage: running out of it throws, as for a cx::vector
+  class object_storage_view
   {
-    using V = value[NObj];
-    using S = cx::basic_string<char, NString>;
+  public:
+    constexpr object_storage_view(value* data, std::size_t capacity)
+      : m_data(data), m_capacity(capacity)
+    {}
+
+    constexpr value& operator[](std::size_t i) const
+    {
+      if (i >= m_capacity) throw std::range_error("Too many values for storage");
+      return m_data[i];
+    }
+
+    constexpr std::size_t capacity() const { return m_capacity; }
+
+  private:
+    value* m_data;
+    std::size_t m_capacity;
+  };
+
+  // the string storage, appended to in place
+  class string_storage_view
+  {
+  public:
+    using value_type = char;
+
+    constexpr string_storage_view(char* data, std::size_t size, std::size_t capacity)
+      : m_data(data), m_size(size), m_capacity(capacity)
+    {}
+
+    constexpr void push_back(char c)
+    {
+      if (m_size >= m_capacity) throw std::range_error("Index past end of vector");
+      m_data[m_size++] = c;
+    }
+
+    // Append the chars at the front of sv that a JSON string holds as they
+    // are - those before the first '"' or '\\' - in one go, checking that
+    // they're UTF-8 if asked to. Returns how many there were.
+    template <bool ValidateUtf8>
+    constexpr cx::utf8_run append_unescaped(std::string_view sv)
+    {
+      const auto room = m_capacity - m_size;
+      const auto n = sv.size() < room ? sv.size() : room;
+      const auto r = cx::utf8_copy_until<ValidateUtf8>(sv.data(), n, m_data + m_size,
+                                                       '"', '\\');
+      if (r.valid && r.size == room && room < sv.size()
+          && sv[room] != '"' && sv[room] != '\\') {
+        throw std::range_error("Index past end of vector");
+      }
+      m_size += r.size;
+      return r;
+    }
+
+    constexpr std::size_t size() const { return m_size; }
+    constexpr std::size_t capacity() const { return m_capacity; }
+
+  private:
+    char* m_data;
+    std::size_t m_size;
+    std::size_t m_capacity;
+  };
+
+  // parse into the storage
+  // return the past-the-end index into the storage resulting from parsing
+
+  // With RawNumbers, numbers are stored as their text (as RawNumbers, which
+  // are decoded on access) rather than decoded while parsing - so the input
+  // must outlive the storage. With ValidateUtf8, a string that isn't
+  // well-formed UTF-8 fails to parse.
+  template <bool RawNumbers = false, bool ValidateUtf8 = false>
+  struct storage_recur
+  {
+    using V = object_storage_view;
+    using S = string_storage_view;
+
+    static constexpr auto stored_number_parser()
+    {
+      if constexpr (RawNumbers) {
+        return fmap([] (std::string_view text) {
+                      value n;
+                      n.to_RawNumber() = text;
+                      return n;
+                    }, number_extent_parser());
+      } else {
+        return number_value_parser();
+      }
+    }
 
     // Here, value_parser returns a lambda with captures, so it can't decay to a
     // function pointer type. clang cannot deduce the return type of
@@ -460,22 +627,22 @@ namespace JSON
       constexpr auto operator()(const parse_input_t& sv) -> parse_result_t<std::size_t>
       {
         using namespace std::literals;
-        const auto p =
-          fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Boolean() = true; return max; },
-               make_string_parser("true"sv))
-          | fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Boolean() = false; return max; },
-                 make_string_parser("false"sv))
-          | fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Null(); return max; },
-                 make_string_parser("null"sv))
-          | fmap([&v = v, idx = idx, max = max] (double d) { v[idx].to_Number() = d; return max; },
-                 number_parser())
-          | fmap([&v = v, idx = idx, max = max] (const value::ExternalView& ev) {
-                   v[idx].to_String() = ev;
-                   return max;
-                 }, string_parser(s))
-          | (make_char_parser('[') < array_parser(v, s, idx, max))
-          | (make_char_parser('{') < object_parser(v, s, idx, max))
-        ;
+        const auto p = dispatch(
+            arm("t"sv, fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Boolean() = true; return max; },
+                            make_string_parser("true"sv))),
+            arm("f"sv, fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Boolean() = false; return max; },
+                            make_string_parser("false"sv))),
+            arm("n"sv, fmap([&v = v, idx = idx, max = max] (auto) { v[idx].to_Null(); return max; },
+                            make_string_parser("null"sv))),
+            arm("-0123456789"sv,
+                fmap([&v = v, idx = idx, max = max] (const value& n) { v[idx] = n; return max; },
+                     stored_number_parser())),
+            arm("\""sv, fmap([&v = v, idx = idx, max = max] (const value::ExternalView& ev) {
+                               v[idx].to_String() = ev;
+                               return max;
+                             }, string_parser(s))),
+            arm("["sv, make_char_parser('[') < array_parser(v, s, idx, max)),
+            arm("{"sv, make_char_parser('{') < object_parser(v, s, idx, max)));
         return (skip_whitespace() < p)(sv);
       }
 
@@ -500,45 +667,53 @@ namespace JSON
       return lambda(v, s, idx, max);
 #else
       using namespace std::literals;
-      return [&] (const auto& sv) -> parse_result_t<std::size_t> {
-        const auto p =
-          fmap([&] (auto) { v[idx].to_Boolean() = true; return max; },
-               make_string_parser("true"sv))
-          | fmap([&] (auto) { v[idx].to_Boolean() = false; return max; },
-                 make_string_parser("false"sv))
-          | fmap([&] (auto) { v[idx].to_Null(); return max; },
-                 make_string_parser("null"sv))
-          | fmap([&] (double d) { v[idx].to_Number() = d; return max; },
-                 number_parser())
-          | fmap([&] (const value::ExternalView& ev) {
-                   v[idx].to_String() = ev;
-                   return max;
-                 }, string_parser(s))
-          | (make_char_parser('[') < array_parser(v, s, idx, max))
-          | (make_char_parser('{') < object_parser(v, s, idx, max))
-        ;
+      return [&] (parse_input_t sv) -> parse_result_t<std::size_t> {
+        const auto p = dispatch(
+            arm("t"sv, fmap([&] (auto) { v[idx].to_Boolean() = true; return max; },
+                            make_string_parser("true"sv))),
+            arm("f"sv, fmap([&] (auto) { v[idx].to_Boolean() = false; return max; },
+                            make_string_parser("false"sv))),
+            arm("n"sv, fmap([&] (auto) { v[idx].to_Null(); return max; },
+                            make_string_parser("null"sv))),
+            arm("-0123456789"sv, fmap([&] (const value& n) { v[idx] = n; return max; },
+                                      stored_number_parser())),
+            arm("\""sv, fmap([&] (const value::ExternalView& ev) {
+                               v[idx].to_String() = ev;
+                               return max;
+                             }, string_parser(s))),
+            arm("["sv, make_char_parser('[') < array_parser(v, s, idx, max)),
+            arm("{"sv, make_char_parser('{') < object_parser(v, s, idx, max)));
         return (skip_whitespace() < p)(sv);
       };
 #endif
     }
 
-    // a string parser which accumulates its string into external storage - we
-    // use the max value of size_t as a sentinel to lazily evaluate the
-    // beginning of the string... I'm not proud
+    // a string parser which accumulates its string into external storage:
+    // the runs of chars between escapes are copied (and validated) a run at
+    // a time, and only the escapes go through string_char_parser
 
     static constexpr auto string_parser(S& s)
     {
-      constexpr auto quote_parser = make_char_parser('"');
-      const auto str_parser =
-        many(string_char_parser(),
-             value::ExternalView{std::numeric_limits<std::size_t>::max(), 0},
-             [&] (auto ev, const auto& str) {
-               auto offset = ev.offset == std::numeric_limits<std::size_t>::max()
-                 ? s.size() : ev.offset;
-               cx::copy(str.cbegin(), str.cend(), cx::back_insert_iterator(s));
-               return value::ExternalView{offset, ev.extent + str.size()};
-             });
-      return quote_parser < str_parser > quote_parser;
+      using R = parse_result_t<value::ExternalView>;
+      return [&s] (parse_input_t sv) -> R {
+        if (sv.empty() || sv.front() != '"') return std::nullopt;
+        sv = drop(sv, 1);
+        const auto offset = s.size();
+        while (true) {
+          const auto run = s.template append_unescaped<ValidateUtf8>(sv);
+          if (!run.valid) return std::nullopt;
+          sv = drop(sv, run.size);
+          if (sv.empty()) return std::nullopt;
+          if (sv.front() == '"') break;
+          const auto escaped = string_char_parser()(sv);
+          if (!escaped) return std::nullopt;
+          cx::copy(escaped->first.cbegin(), escaped->first.cend(),
+                   cx::back_insert_iterator(s));
+          sv = escaped->second;
+        }
+        return R(cx::make_pair(value::ExternalView{offset, s.size() - offset},
+                               drop(sv, 1)));
+      };
     }
 
     // parse a JSON array
@@ -631,14 +806,78 @@ namespace JSON
 
   };
 
+  namespace detail
+  {
+    // call f with views of fixed size storage, and keep what it appends to
+    // the strings
+    template <std::size_t NObj, std::size_t NString, typename F>
+    constexpr auto with_storage_views(value (&v)[NObj],
+                                      cx::basic_string<char, NString>& s, F&& f)
+    {
+      const auto size = s.size();
+      decltype(f(std::declval<object_storage_view&>(),
+                 std::declval<string_storage_view&>())) r{};
+      s.resize_and_overwrite(NString, [&] (char* p, std::size_t n) {
+        object_storage_view objects{v, NObj};
+        string_storage_view strings{p, size, n};
+        r = f(objects, strings);
+        return strings.size();
+      });
+      return r;
+    }
+  }
+
+  // parse into fixed size storage, through storage_recur
+  template <std::size_t NObj, std::size_t NString, bool RawNumbers = false,
+            bool ValidateUtf8 = false>
+  struct basic_value_recur
+  {
+    using V = value[NObj];
+    using S = cx::basic_string<char, NString>;
+
+    static constexpr auto value_parser(V& v, S& s,
+                                       const std::size_t& idx,
+                                       const std::size_t& max)
+    {
+      return [&] (const parse_input_t& sv) {
+        return detail::with_storage_views(
+            v, s, [&] (object_storage_view& objects, string_storage_view& strings) {
+              return storage_recur<RawNumbers, ValidateUtf8>::value_parser(
+                  objects, strings, idx, max)(sv);
+            });
+      };
+    }
+  };
+
+  template <std::size_t NObj, std::size_t NString>
+  using value_recur = basic_value_recur<NObj, NString>;
+
+  // parse leaving numbers as their text, to be decoded on access: e.g.
+  //
+  //   w.construct<JSON::raw_number_recur>(text);
+  //
+  // where text must outlive w
+  template <std::size_t NObj, std::size_t NString>
+  using raw_number_recur = basic_value_recur<NObj, NString, true>;
+
+  // parse checking that strings are well-formed UTF-8 (the text, that is:
+  // \u escapes are trusted), e.g.
+  //
+  //   w.construct<JSON::utf8_value_recur>(text);
+  template <std::size_t NObj, std::size_t NString>
+  using utf8_value_recur = basic_value_recur<NObj, NString, false, true>;
+
   // A value_wrapper wraps a parsed JSON::value and contains the externalized
   // storage.
   template <size_t NumObjects, size_t StringSize>
   struct value_wrapper
   {
+    // Recur is the parser for the input format: by default JSON text, but
+    // e.g. cbor_recur decodes CBOR into the same storage
+    template <template <std::size_t, std::size_t> class Recur = value_recur>
     constexpr void construct(parse_input_t s)
     {
-      value_recur<NumObjects, StringSize>::value_parser(
+      Recur<NumObjects, StringSize>::value_parser(
           object_storage, string_storage, 0, 1)(s);
     }
 
@@ -693,12 +932,27 @@ namespace JSON
     constexpr decltype(auto) to_Number() const { return object_storage[0].to_Number(); }
     constexpr decltype(auto) to_Number() { return object_storage[0].to_Number(); }
 
+    constexpr decltype(auto) as_Int64() const { return object_storage[0].as_Int64(); }
+    constexpr decltype(auto) as_UInt64() const { return object_storage[0].as_UInt64(); }
+
+    constexpr decltype(auto) to_Int64() const { return object_storage[0].to_Int64(); }
+    constexpr decltype(auto) to_Int64() { return object_storage[0].to_Int64(); }
+
+    constexpr decltype(auto) to_UInt64() const { return object_storage[0].to_UInt64(); }
+    constexpr decltype(auto) to_UInt64() { return object_storage[0].to_UInt64(); }
+
+    constexpr decltype(auto) to_RawNumber() const { return object_storage[0].to_RawNumber(); }
+
     constexpr decltype(auto) to_Boolean() const { return object_storage[0].to_Boolean(); }
     constexpr decltype(auto) to_Boolean() { return object_storage[0].to_Boolean(); }
 
     constexpr auto num_objects() const { return NumObjects; }
     constexpr auto string_size() const { return StringSize; }
 
+    // the externalized storage itself, e.g. for serialization
+    constexpr const auto& objects() const { return object_storage; }
+    constexpr const auto& strings() const { return string_storage; }
+
   private:
     // when this is a cx::vector, GCC ICEs...
     value object_storage[NumObjects];
@@ -708,6 +962,24 @@ namespace JSON
   namespace literals
   {
 
+#if CX_HAS_CLASS_NTTP
+    // With C++20 the literal is a single template argument, rather than a
+    // template argument per char, which is far cheaper to compile.
+    template <cx::fixed_string Str>
+    constexpr auto operator "" _json()
+    {
+      constexpr auto S = sizes(Str.view());
+      auto val = value_wrapper<S.num_objects, S.string_size>{};
+      val.construct(Str.view());
+      return val;
+    }
+#else
+    // Before C++20, this relies on the GNU extension for string literal
+    // operator templates.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
     // why cannot we get regular literal operator template here?
     template <typename T, T... Ts>
     constexpr auto operator "" _json()
@@ -720,6 +992,10 @@ namespace JSON
       val.construct(std::string_view(il.begin(), il.size()));
       return val;
     }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
 
   }
 
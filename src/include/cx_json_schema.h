@@ -0,0 +1,537 @@
+#pragma once
+
+#include <cx_algorithm.h>
+#include <cx_json_parser.h>
+#include <cx_json_value.h>
+#include <cx_parser.h>
+#include <cx_string.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+// Validation of JSON text against a JSON Schema, compiled at compile time from
+// a schema written as a _json literal:
+//
+//   constexpr auto schema = R"({"type": "object",
+//                               "required": ["id"],
+//                               "properties": {"id": {"type": "integer",
+//                                                     "minimum": 0}}})"_json;
+//   constexpr auto validate = JSON::make_schema_validator(schema);
+//   static_assert(validate(R"({"id": 3})"sv));
+//
+// The validator checks the input in a single pass as it parses it: no value
+// storage is built. Parts of the input the schema says nothing about are
+// skipped with extent_parser, which still checks that they are well formed.
+//
+// The subset supported is: type (a name or an array of names), enum and const
+// (of scalars), minimum, maximum, exclusiveMinimum, exclusiveMaximum (as
+// numbers, or as booleans in the draft 4 style), minLength, maxLength,
+// minItems, maxItems, items (a single schema), properties, required and
+// additionalProperties (a boolean). Annotations ($schema, $id, title,
+// description) are ignored; any other keyword is an error in the schema, so
+// that a constraint is never silently left unchecked.
+
+namespace JSON
+{
+  // the types a schema can ask for, as a bit set
+  enum schema_type : unsigned
+  {
+    schema_null = 1u << 0,
+    schema_boolean = 1u << 1,
+    schema_integer = 1u << 2,
+    schema_number = 1u << 3,   // (number includes integer)
+    schema_string = 1u << 4,
+    schema_array = 1u << 5,
+    schema_object = 1u << 6,
+    schema_any = (1u << 7) - 1
+  };
+
+  // a compiled schema (or subschema)
+  struct schema_node
+  {
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    unsigned types = schema_any;
+
+    // minimum and maximum (which a draft 4 boolean exclusiveMinimum or
+    // exclusiveMaximum makes exclusive), and the exclusiveMinimum and
+    // exclusiveMaximum numbers: a schema may have both, and both apply
+    bool has_minimum = false;
+    bool has_maximum = false;
+    bool minimum_is_exclusive = false;
+    bool maximum_is_exclusive = false;
+    double minimum = 0;
+    double maximum = 0;
+    bool has_exclusive_minimum = false;
+    bool has_exclusive_maximum = false;
+    double exclusive_minimum = 0;
+    double exclusive_maximum = 0;
+
+    // string lengths are in code points
+    std::size_t min_length = 0;
+    std::size_t max_length = none;
+
+    std::size_t min_items = 0;
+    std::size_t max_items = none;
+    std::size_t items = none;
+
+    // the object's properties (and required keys) are a contiguous range of
+    // the property table
+    std::size_t properties_offset = 0;
+    std::size_t properties_count = 0;
+    bool additional_properties = true;
+
+    // the allowed values, as a range of the schema's value storage
+    bool has_enum = false;
+    value::ExternalView enum_values{0, 0};
+  };
+
+  // a key from properties (which has a node) or required (which may not: it
+  // is then an additional property, as far as additionalProperties goes)
+  struct schema_property
+  {
+    value::ExternalView key{0, 0};
+    std::size_t node = schema_node::none;
+    bool required = false;
+  };
+
+  namespace detail
+  {
+    // the required keys of an object are tracked in a bit set
+    inline constexpr std::size_t schema_max_properties = 64;
+
+    // the string contents between the quotes, still escaped, and the rest
+    struct raw_string
+    {
+      parse_input_t contents;
+      parse_input_t rest;
+    };
+
+    constexpr cx::optional<raw_string> raw_string_token(parse_input_t in)
+    {
+      const auto r = string_size_parser()(in);
+      if (!r) return std::nullopt;
+      const auto len = static_cast<std::size_t>(r->second.data() - in.data());
+      return cx::optional<raw_string>(raw_string{in.substr(1, len - 2), r->second});
+    }
+
+    // the number of code points in an (escaped) string
+    constexpr std::size_t code_point_count(parse_input_t raw)
+    {
+      std::size_t n = 0;
+      while (!raw.empty()) {
+        const auto r = string_char_parser()(raw);
+        for (const auto c : r->first) {
+          if ((static_cast<unsigned char>(c) & 0xc0u) != 0x80u) ++n;
+        }
+        raw = r->second;
+      }
+      return n;
+    }
+
+    // compare an (escaped) string to an unescaped one, without unescaping it
+    // into storage
+    template <typename It>
+    constexpr bool string_equals(parse_input_t raw, It first, It last)
+    {
+      while (!raw.empty()) {
+        const auto r = string_char_parser()(raw);
+        for (const auto c : r->first) {
+          if (first == last || *first != c) return false;
+          ++first;
+        }
+        raw = r->second;
+      }
+      return first == last;
+    }
+
+    constexpr bool is_integral(double d)
+    {
+      // every double at least this large is an integer
+      constexpr double two53 = 9007199254740992.0;
+      if (d >= two53 || d <= -two53) return true;
+      return static_cast<double>(static_cast<std::int64_t>(d)) == d;
+    }
+  }
+
+  template <std::size_t NumObjects, std::size_t StringSize>
+  class schema_validator
+  {
+  public:
+    // compile a parsed schema
+    template <typename Schema>
+    constexpr explicit schema_validator(const Schema& schema)
+      : m_strings(schema.strings())
+    {
+      const auto& objects = schema.objects();
+      for (std::size_t i = 0; i < NumObjects; ++i) m_objects[i] = objects[i];
+      compile(0);
+    }
+
+    // validate JSON text
+    constexpr bool operator()(parse_input_t in) const
+    {
+      if (!validate(0, in)) return false;
+      return skip_whitespace()(in)->second.empty();
+    }
+
+    constexpr std::size_t num_nodes() const { return m_num_nodes; }
+    constexpr const schema_node& node(std::size_t i) const { return m_nodes[i]; }
+
+  private:
+    //--------------------------------------------------------------------------
+    // schema compilation
+
+    constexpr std::string_view string_at(const value::ExternalView& ev) const
+    {
+      return std::string_view{m_strings.data() + ev.offset, ev.extent};
+    }
+
+    constexpr const value& number_at(std::size_t i) const
+    {
+      if (!m_objects[i].is_Number()) throw std::runtime_error("Schema value must be a number");
+      return m_objects[i];
+    }
+
+    constexpr std::size_t size_at(std::size_t i) const
+    {
+      const auto d = number_at(i).to_Number();
+      if (d < 0 || !detail::is_integral(d)) {
+        throw std::runtime_error("Schema length must be a non-negative integer");
+      }
+      return static_cast<std::size_t>(d);
+    }
+
+    constexpr unsigned type_named(const value& name) const
+    {
+      using namespace std::literals;
+      const auto s = string_at(name.to_String());
+      if (s == "null"sv) return schema_null;
+      if (s == "boolean"sv) return schema_boolean;
+      if (s == "integer"sv) return schema_integer;
+      if (s == "number"sv) return schema_number | schema_integer;
+      if (s == "string"sv) return schema_string;
+      if (s == "array"sv) return schema_array;
+      if (s == "object"sv) return schema_object;
+      throw std::runtime_error("Unknown schema type");
+    }
+
+    constexpr void check_enum(const value::ExternalView& ev) const
+    {
+      for (auto i = ev.offset; i < ev.offset + ev.extent; ++i) {
+        const auto t = m_objects[i].type;
+        if (t == value::Type::Array || t == value::Type::Object) {
+          throw std::runtime_error("Schema enum values must be scalars");
+        }
+      }
+    }
+
+    // compile the schema at m_objects[idx], returning the node index
+    constexpr std::size_t compile(std::size_t idx)
+    {
+      using namespace std::literals;
+      const auto ext = m_objects[idx].to_Object();
+      const auto n = m_num_nodes++;
+      schema_node node{};
+      std::size_t properties = schema_node::none;
+      std::size_t required = schema_node::none;
+
+      for (auto i = ext.offset; i < ext.offset + ext.extent; i += 2) {
+        const auto k = string_at(m_objects[i].to_String());
+        const auto& v = m_objects[i+1];
+        if (k == "type"sv) {
+          if (v.type == value::Type::Array) {
+            node.types = 0;
+            const auto& names = v.to_Array();
+            for (auto j = names.offset; j < names.offset + names.extent; ++j) {
+              node.types |= type_named(m_objects[j]);
+            }
+          } else {
+            node.types = type_named(v);
+          }
+        } else if (k == "enum"sv) {
+          node.has_enum = true;
+          node.enum_values = v.to_Array();
+          check_enum(node.enum_values);
+        } else if (k == "const"sv) {
+          node.has_enum = true;
+          node.enum_values = value::ExternalView{i+1, 1};
+          check_enum(node.enum_values);
+        } else if (k == "minimum"sv) {
+          node.has_minimum = true;
+          node.minimum = number_at(i+1).to_Number();
+        } else if (k == "maximum"sv) {
+          node.has_maximum = true;
+          node.maximum = number_at(i+1).to_Number();
+        } else if (k == "exclusiveMinimum"sv) {
+          if (v.type == value::Type::Boolean) {
+            node.minimum_is_exclusive = v.to_Boolean();
+          } else {
+            node.has_exclusive_minimum = true;
+            node.exclusive_minimum = number_at(i+1).to_Number();
+          }
+        } else if (k == "exclusiveMaximum"sv) {
+          if (v.type == value::Type::Boolean) {
+            node.maximum_is_exclusive = v.to_Boolean();
+          } else {
+            node.has_exclusive_maximum = true;
+            node.exclusive_maximum = number_at(i+1).to_Number();
+          }
+        } else if (k == "minLength"sv) {
+          node.min_length = size_at(i+1);
+        } else if (k == "maxLength"sv) {
+          node.max_length = size_at(i+1);
+        } else if (k == "minItems"sv) {
+          node.min_items = size_at(i+1);
+        } else if (k == "maxItems"sv) {
+          node.max_items = size_at(i+1);
+        } else if (k == "items"sv) {
+          node.items = i+1;
+        } else if (k == "properties"sv) {
+          properties = i+1;
+        } else if (k == "required"sv) {
+          required = i+1;
+        } else if (k == "additionalProperties"sv) {
+          node.additional_properties = v.to_Boolean();
+        } else if (k != "$schema"sv && k != "$id"sv
+                   && k != "title"sv && k != "description"sv) {
+          throw std::runtime_error("Unsupported schema keyword");
+        }
+      }
+
+      // reserve this node's block of the property table before compiling
+      // subschemas, which take blocks of their own
+      node.properties_offset = m_num_properties;
+      if (properties != schema_node::none) {
+        const auto& props = m_objects[properties].to_Object();
+        for (auto i = props.offset; i < props.offset + props.extent; i += 2) {
+          add_property(node, m_objects[i].to_String()).node = i+1;
+        }
+      }
+      if (required != schema_node::none) {
+        const auto& names = m_objects[required].to_Array();
+        for (auto i = names.offset; i < names.offset + names.extent; ++i) {
+          add_property(node, m_objects[i].to_String()).required = true;
+        }
+      }
+      m_num_properties += node.properties_count;
+
+      // now compile the subschemas (node and items hold value indices until
+      // here)
+      for (std::size_t i = 0; i < node.properties_count; ++i) {
+        auto& p = m_properties[node.properties_offset + i];
+        if (p.node != schema_node::none) p.node = compile(p.node);
+      }
+      if (node.items != schema_node::none) node.items = compile(node.items);
+
+      m_nodes[n] = node;
+      return n;
+    }
+
+    constexpr schema_property& add_property(schema_node& node,
+                                            const value::ExternalView& key)
+    {
+      const auto k = string_at(key);
+      for (std::size_t i = 0; i < node.properties_count; ++i) {
+        auto& p = m_properties[node.properties_offset + i];
+        if (string_at(p.key) == k) return p;
+      }
+      if (node.properties_count == detail::schema_max_properties) {
+        throw std::runtime_error("Too many properties in schema object");
+      }
+      auto& p = m_properties[node.properties_offset + node.properties_count++];
+      p = schema_property{key, schema_node::none, false};
+      return p;
+    }
+
+    //--------------------------------------------------------------------------
+    // validation
+
+    constexpr bool check_number(const schema_node& node, double d) const
+    {
+      if (!(node.types & schema_number)
+          && !((node.types & schema_integer) && detail::is_integral(d))) {
+        return false;
+      }
+      if (node.has_minimum
+          && (node.minimum_is_exclusive ? d <= node.minimum : d < node.minimum)) {
+        return false;
+      }
+      if (node.has_maximum
+          && (node.maximum_is_exclusive ? d >= node.maximum : d > node.maximum)) {
+        return false;
+      }
+      if (node.has_exclusive_minimum && d <= node.exclusive_minimum) return false;
+      if (node.has_exclusive_maximum && d >= node.exclusive_maximum) return false;
+      if (!node.has_enum) return true;
+      const auto& ev = node.enum_values;
+      for (auto i = ev.offset; i < ev.offset + ev.extent; ++i) {
+        if (m_objects[i].is_Number() && m_objects[i].to_Number() == d) return true;
+      }
+      return false;
+    }
+
+    constexpr bool check_string(const schema_node& node, parse_input_t raw) const
+    {
+      if (!(node.types & schema_string)) return false;
+      if (node.min_length != 0 || node.max_length != schema_node::none) {
+        const auto n = detail::code_point_count(raw);
+        if (n < node.min_length || n > node.max_length) return false;
+      }
+      if (!node.has_enum) return true;
+      const auto& ev = node.enum_values;
+      for (auto i = ev.offset; i < ev.offset + ev.extent; ++i) {
+        if (m_objects[i].type != value::Type::String) continue;
+        const auto s = string_at(m_objects[i].to_String());
+        if (detail::string_equals(raw, s.cbegin(), s.cend())) return true;
+      }
+      return false;
+    }
+
+    constexpr bool check_literal(const schema_node& node, const value& v) const
+    {
+      const auto t = v.type == value::Type::Null ? schema_null : schema_boolean;
+      if (!(node.types & t)) return false;
+      if (!node.has_enum) return true;
+      const auto& ev = node.enum_values;
+      for (auto i = ev.offset; i < ev.offset + ev.extent; ++i) {
+        const auto& e = m_objects[i];
+        if (e.type == v.type
+            && (v.type == value::Type::Null || e.to_Boolean() == v.to_Boolean())) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // skip a value the schema says nothing about
+    static constexpr bool skip_value(parse_input_t& in)
+    {
+      const auto r = extent_parser()(in);
+      if (!r) return false;
+      in = r->second;
+      return true;
+    }
+
+    static constexpr bool expect(parse_input_t& in, char c)
+    {
+      in = skip_whitespace()(in)->second;
+      if (in.empty() || in[0] != c) return false;
+      in.remove_prefix(1);
+      return true;
+    }
+
+    // validate the value at the front of in against node n, consuming it
+    constexpr bool validate(std::size_t n, parse_input_t& in) const
+    {
+      if (n == schema_node::none) return skip_value(in);
+      const auto& node = m_nodes[n];
+      in = skip_whitespace()(in)->second;
+      if (in.empty()) return false;
+
+      using namespace std::literals;
+      switch (in[0]) {
+        case 't':
+        case 'f':
+        case 'n': {
+          const auto b = bool_parser()(in);
+          if (b) {
+            in = b->second;
+            return check_literal(node, value{b->first});
+          }
+          const auto z = null_parser()(in);
+          if (!z) return false;
+          in = z->second;
+          return check_literal(node, value{z->first});
+        }
+        case '"': {
+          const auto r = detail::raw_string_token(in);
+          if (!r) return false;
+          in = r->rest;
+          return check_string(node, r->contents);
+        }
+        case '[':
+          return validate_array(node, in);
+        case '{':
+          return validate_object(node, in);
+        default: {
+          const auto r = number_parser()(in);
+          if (!r) return false;
+          in = r->second;
+          return check_number(node, r->first);
+        }
+      }
+    }
+
+    constexpr bool validate_array(const schema_node& node, parse_input_t& in) const
+    {
+      if (!(node.types & schema_array) || node.has_enum) return false;
+      in.remove_prefix(1);
+      std::size_t count = 0;
+      if (!expect(in, ']')) {
+        do {
+          if (!validate(node.items, in)) return false;
+          ++count;
+        } while (expect(in, ','));
+        if (!expect(in, ']')) return false;
+      }
+      return count >= node.min_items && count <= node.max_items;
+    }
+
+    constexpr bool validate_object(const schema_node& node, parse_input_t& in) const
+    {
+      if (!(node.types & schema_object) || node.has_enum) return false;
+      in.remove_prefix(1);
+      std::uint64_t seen = 0;
+      if (!expect(in, '}')) {
+        do {
+          in = skip_whitespace()(in)->second;
+          const auto key = detail::raw_string_token(in);
+          if (!key) return false;
+          in = key->rest;
+          if (!expect(in, ':')) return false;
+
+          std::size_t i = 0;
+          for (; i < node.properties_count; ++i) {
+            const auto k = string_at(m_properties[node.properties_offset + i].key);
+            if (detail::string_equals(key->contents, k.cbegin(), k.cend())) break;
+          }
+          if (i == node.properties_count) {
+            if (!node.additional_properties || !skip_value(in)) return false;
+          } else {
+            const auto& p = m_properties[node.properties_offset + i];
+            if (p.node == schema_node::none && !node.additional_properties) return false;
+            seen |= std::uint64_t{1} << i;
+            if (!validate(p.node, in)) return false;
+          }
+        } while (expect(in, ','));
+        if (!expect(in, '}')) return false;
+      }
+      for (std::size_t i = 0; i < node.properties_count; ++i) {
+        if (m_properties[node.properties_offset + i].required
+            && !(seen & (std::uint64_t{1} << i))) return false;
+      }
+      return true;
+    }
+
+    value m_objects[NumObjects]{};
+    cx::basic_string<char, StringSize> m_strings;
+
+    // there are no more schemas, or properties, than there are values
+    schema_node m_nodes[NumObjects]{};
+    std::size_t m_num_nodes = 0;
+    schema_property m_properties[NumObjects]{};
+    std::size_t m_num_properties = 0;
+  };
+
+  // compile a schema (a value_wrapper, e.g. from a _json literal)
+  template <std::size_t NumObjects, std::size_t StringSize>
+  constexpr auto make_schema_validator(const value_wrapper<NumObjects, StringSize>& schema)
+  {
+    return schema_validator<NumObjects, StringSize>{schema};
+  }
+
+}
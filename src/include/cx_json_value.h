@@ -1,10 +1,14 @@
 #pragma once
 
 #include "cx_algorithm.h"
+#include "cx_json_number.h"
 #include "cx_map.h"
 #include "cx_string.h"
 #include "cx_vector.h"
 
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 #include <string_view>
 #include <variant>
 
@@ -27,12 +31,16 @@ namespace JSON
       std::string_view unparsed;
       ExternalView external;
       double number;
+      std::int64_t integer;
+      std::uint64_t uinteger;
       bool boolean;
 
       constexpr Data() : boolean(false) {}
       constexpr Data(const std::string_view& sv) : unparsed(sv) {}
       constexpr Data(bool b) : boolean(b) {}
       constexpr Data(double d) : number(d) {}
+      constexpr Data(std::int64_t i) : integer(i) {}
+      constexpr Data(std::uint64_t u) : uinteger(u) {}
       constexpr Data(const ExternalView& ev) : external(ev) {}
     };
 
@@ -44,7 +52,14 @@ namespace JSON
       Array,
       Object,
       Boolean,
-      Null
+      Null,
+      // integers that are kept exactly: Integer where they fit in an int64,
+      // Unsigned for larger ones (numbers that are neither are Numbers)
+      Integer,
+      Unsigned,
+      // a number left as its text (in data.unparsed), and decoded when it is
+      // accessed: see storage_recur<true>
+      RawNumber
     };
 
     Type type = Type::Null;
@@ -72,6 +87,12 @@ namespace JSON
       to_String() = std::move(t_s);
     }
 
+    // any type, initializing the union member directly (as generated code
+    // does; see tools/cx_embed_json.cpp)
+    constexpr value(Type t, Data d)
+      : type(t), data(d)
+    {}
+
     constexpr decltype(auto) to_Object() const
     {
       assert_type(Type::Object);
@@ -170,21 +191,198 @@ namespace JSON
       return data.external.extent;
     }
 
-    constexpr const double& to_Number() const
+    constexpr bool is_Number() const
+    {
+      return type == Type::Number || type == Type::Integer || type == Type::Unsigned
+        || type == Type::RawNumber;
+    }
+
+    // the value of the number in parts: exactly, if it's an integer that fits
+    static constexpr value from_number(const detail::number_parts& p)
+    {
+      constexpr auto int_max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+      std::uint64_t m = 0;
+      if (p.fraction.empty() && p.exponent.empty()
+          && detail::integer_magnitude(p.integral, m)) {
+        if (!p.negative) {
+          if (m <= int_max) return value{Type::Integer, Data(static_cast<std::int64_t>(m))};
+          return value{Type::Unsigned, Data(m)};
+        }
+        if (m <= int_max) {
+          return value{Type::Integer, Data(-static_cast<std::int64_t>(m))};
+        }
+        if (m == int_max + 1) {
+          return value{Type::Integer, Data(std::numeric_limits<std::int64_t>::min())};
+        }
+      }
+      return value{Type::Number, Data(detail::to_double(p))};
+    }
+
+    // the text of a raw number, e.g. to write it out as it was read
+    constexpr const std::string_view& to_RawNumber() const
+    {
+      assert_type(Type::RawNumber);
+      return data.unparsed;
+    }
+
+    constexpr std::string_view& to_RawNumber()
+    {
+      if (type != Type::RawNumber) {
+        type = Type::RawNumber;
+        data = Data(std::string_view{});
+      }
+      return data.unparsed;
+    }
+
+    // a raw number decoded (anything else as it is)
+    constexpr value decode_number() const
+    {
+      if (type != Type::RawNumber) return *this;
+      const auto p = detail::scan_number(data.unparsed);
+      if (p.size == 0 || p.size != data.unparsed.size()) {
+        throw std::runtime_error("Malformed number");
+      }
+      return from_number(p);
+    }
+
+    // The numeric accessors convert between the kinds of number on request:
+    // integers to doubles always, and to other integers only exactly. A
+    // const access (or as_Int64(), as_UInt64()) throws if the value isn't
+    // exactly representable; a non-const access, which is for assigning
+    // through, converts it if it is, and otherwise resets it to 0 (as the
+    // other accessors do on a change of type). to_Number() is the value as a
+    // double, whatever the kind. A raw number is decoded by every const
+    // access; a non-const access decodes it in place, so that it is only
+    // decoded once.
+    constexpr double to_Number() const
     {
+      if (type == Type::Integer) return static_cast<double>(data.integer);
+      if (type == Type::Unsigned) return static_cast<double>(data.uinteger);
+      if (type == Type::RawNumber) return decode_number().to_Number();
       assert_type(Type::Number);
       return data.number;
     }
 
     constexpr double& to_Number()
     {
+      if (type == Type::RawNumber) *this = decode_number();
       if (type != Type::Number) {
+        const auto d = is_Number() ? static_cast<const value&>(*this).to_Number() : 0.0;
         type = Type::Number;
-        data = Data(0.0);
+        data = Data(d);
       }
       return data.number;
     }
 
+    // the number as an int64_t, if it is exactly one
+    constexpr bool exact_Int64(std::int64_t& i) const
+    {
+      switch (type) {
+        case Type::Integer:
+          i = data.integer;
+          return true;
+        case Type::Unsigned:
+          if (data.uinteger > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+            return false;
+          }
+          i = static_cast<std::int64_t>(data.uinteger);
+          return true;
+        case Type::RawNumber:
+          return decode_number().exact_Int64(i);
+        case Type::Number: {
+          // -2^63 is exact as a double, 2^63 is the first out of range
+          constexpr double two63 = 9223372036854775808.0;
+          if (!(data.number >= -two63 && data.number < two63)
+              || static_cast<double>(static_cast<std::int64_t>(data.number)) != data.number) {
+            return false;
+          }
+          i = static_cast<std::int64_t>(data.number);
+          return true;
+        }
+        default:
+          return false;
+      }
+    }
+
+    // the number as a uint64_t, if it is exactly one
+    constexpr bool exact_UInt64(std::uint64_t& u) const
+    {
+      switch (type) {
+        case Type::Unsigned:
+          u = data.uinteger;
+          return true;
+        case Type::Integer:
+          if (data.integer < 0) return false;
+          u = static_cast<std::uint64_t>(data.integer);
+          return true;
+        case Type::RawNumber:
+          return decode_number().exact_UInt64(u);
+        case Type::Number: {
+          constexpr double two64 = 18446744073709551616.0;
+          if (!(data.number >= 0 && data.number < two64)
+              || static_cast<double>(static_cast<std::uint64_t>(data.number)) != data.number) {
+            return false;
+          }
+          u = static_cast<std::uint64_t>(data.number);
+          return true;
+        }
+        default:
+          return false;
+      }
+    }
+
+    constexpr std::int64_t as_Int64() const
+    {
+      std::int64_t i = 0;
+      if (!exact_Int64(i)) {
+        const auto t = decode_number().type;
+        if (t == Type::Number) throw std::range_error("Number is not an exact integer");
+        if (t == Type::Unsigned) throw std::range_error("Integer out of range");
+        throw std::runtime_error("Incorrect type");
+      }
+      return i;
+    }
+
+    constexpr std::uint64_t as_UInt64() const
+    {
+      std::uint64_t u = 0;
+      if (!exact_UInt64(u)) {
+        const auto t = decode_number().type;
+        if (t == Type::Number) throw std::range_error("Number is not an exact integer");
+        if (t == Type::Integer) throw std::range_error("Integer out of range");
+        throw std::runtime_error("Incorrect type");
+      }
+      return u;
+    }
+
+    constexpr std::int64_t to_Int64() const { return as_Int64(); }
+
+    constexpr std::int64_t& to_Int64()
+    {
+      if (type == Type::RawNumber) *this = decode_number();
+      if (type != Type::Integer) {
+        std::int64_t i = 0;
+        if (!exact_Int64(i)) i = 0;
+        type = Type::Integer;
+        data = Data(i);
+      }
+      return data.integer;
+    }
+
+    constexpr std::uint64_t to_UInt64() const { return as_UInt64(); }
+
+    constexpr std::uint64_t& to_UInt64()
+    {
+      if (type == Type::RawNumber) *this = decode_number();
+      if (type != Type::Unsigned) {
+        std::uint64_t u = 0;
+        if (!exact_UInt64(u)) u = 0;
+        type = Type::Unsigned;
+        data = Data(u);
+      }
+      return data.uinteger;
+    }
+
     constexpr const bool& to_Boolean() const
     {
       assert_type(Type::Boolean);
@@ -238,7 +436,7 @@ namespace JSON
     template <typename K,
               std::enable_if_t<!std::is_integral<K>::value, int> = 0>
     constexpr auto operator[](const K& s) const {
-      const auto& ext = object_storage[index].to_Object();
+      const auto ext = object_storage[index].to_Object();
       bool notfound = true;
       for (auto i = ext.offset; i < ext.offset + ext.extent; i += 2) {
         const auto& str = object_storage[i].to_String();
@@ -252,7 +450,7 @@ namespace JSON
     template <typename K,
               std::enable_if_t<!std::is_integral<K>::value, int> = 0>
     constexpr auto operator[](const K& s) {
-      const auto& ext = object_storage[index].to_Object();
+      const auto ext = object_storage[index].to_Object();
       bool notfound = true;
       for (auto i = ext.offset; i < ext.offset + ext.extent; i += 2) {
         const auto& str = object_storage[i].to_String();
@@ -268,12 +466,12 @@ namespace JSON
     }
 
     constexpr auto operator[](std::size_t idx) const {
-      auto& ext = object_storage[index].to_Array();
+      const auto ext = object_storage[index].to_Array();
       if (idx > ext.extent) throw std::runtime_error("Index past end of array");
       return value_proxy{ext.offset + idx, object_storage, string_storage};
     }
     constexpr auto operator[](std::size_t idx) {
-      auto& ext = object_storage[index].to_Array();
+      const auto ext = object_storage[index].to_Array();
       if (idx > ext.extent) throw std::runtime_error("Index past end of array");
       return value_proxy{ext.offset + idx, object_storage, string_storage};
     }
@@ -298,6 +496,17 @@ namespace JSON
     constexpr decltype(auto) to_Number() const { return object_storage[index].to_Number(); }
     constexpr decltype(auto) to_Number() { return object_storage[index].to_Number(); }
 
+    constexpr decltype(auto) as_Int64() const { return object_storage[index].as_Int64(); }
+    constexpr decltype(auto) as_UInt64() const { return object_storage[index].as_UInt64(); }
+
+    constexpr decltype(auto) to_Int64() const { return object_storage[index].to_Int64(); }
+    constexpr decltype(auto) to_Int64() { return object_storage[index].to_Int64(); }
+
+    constexpr decltype(auto) to_UInt64() const { return object_storage[index].to_UInt64(); }
+    constexpr decltype(auto) to_UInt64() { return object_storage[index].to_UInt64(); }
+
+    constexpr decltype(auto) to_RawNumber() const { return object_storage[index].to_RawNumber(); }
+
     constexpr decltype(auto) to_Boolean() const { return object_storage[index].to_Boolean(); }
     constexpr decltype(auto) to_Boolean() { return object_storage[index].to_Boolean(); }
 
@@ -312,6 +521,10 @@ namespace JSON
     -> value_proxy<NumObjects, const value(&)[NumObjects],
                    const cx::basic_string<char, StringSize>>;
 
+  template <size_t NumObjects, size_t StringSize>
+  value_proxy(std::size_t i, const value(&v)[NumObjects], const char (&s)[StringSize])
+    -> value_proxy<NumObjects, const value(&)[NumObjects], const char[StringSize]>;
+
   template <size_t NumObjects, size_t StringSize>
   value_proxy(std::size_t i, value(&v)[NumObjects],
               cx::basic_string<char, StringSize>& s)
@@ -2,8 +2,8 @@
 
 #include "cx_algorithm.h"
 #include "cx_pair.h"
+#include "cx_vector.h"
 
-#include <array>
 #include <cstddef>
 #include <functional>
 #include <stdexcept>
@@ -28,22 +28,19 @@ namespace cx
     constexpr auto begin() const { return m_data.begin(); }
     constexpr auto begin() { return m_data.begin(); }
 
-    // We would have prefered to use `std::next`, however it does not seem
-    // to be enabled for constexpr use for std::array in this version
-    // of gcc. TODO: reevaluate this
-    constexpr auto end() const { return m_data.begin() + m_size; }
-    constexpr auto end() { return m_data.begin() + m_size; }
+    constexpr auto end() const { return m_data.end(); }
+    constexpr auto end() { return m_data.end(); }
 
-    constexpr auto cbegin() const { return m_data.begin(); }
-    constexpr auto cend() const { return m_data.begin() + m_size; }
+    constexpr auto cbegin() const { return m_data.cbegin(); }
+    constexpr auto cend() const { return m_data.cend(); }
 
     constexpr auto find(const Key &k)
     {
       return find_impl(*this, k);
     }
 
-    template <typename K,
-              std::enable_if_t<has_is_transparent<Compare>::value, int> = 0>
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
     constexpr auto find(const K &k)
     {
       return find_impl(*this, k);
@@ -54,8 +51,8 @@ namespace cx
       return find_impl(*this, k);
     }
 
-    template <typename K,
-              std::enable_if_t<has_is_transparent<Compare>::value, int> = 0>
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
     constexpr auto find(const K &k) const
     {
       return find_impl(*this, k);
@@ -68,8 +65,8 @@ namespace cx
       else { throw std::range_error("Key not found"); }
     }
 
-    template <typename K,
-              std::enable_if_t<has_is_transparent<Compare>::value, int> = 0>
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
     constexpr const Value &at(const K &k) const
     {
       const auto itr = find(k);
@@ -80,7 +77,7 @@ namespace cx
     constexpr Value &operator[](const Key &k) {
       const auto itr = find(k);
       if (itr == end()) {
-        auto &data = m_data[m_size++];
+        auto &data = m_data.push_back({});
         data.first = k;
         return data.second;
       } else {
@@ -88,12 +85,12 @@ namespace cx
       }
     }
 
-    template <typename K,
-              std::enable_if_t<has_is_transparent<Compare>::value, int> = 0>
+    template <typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
     constexpr Value &operator[](const K &k) {
       const auto itr = find(k);
       if (itr == end()) {
-        auto &data = m_data[m_size++];
+        auto &data = m_data.push_back({});
         data.first = k;
         return data.second;
       } else {
@@ -101,8 +98,8 @@ namespace cx
       }
     }
 
-    constexpr auto size() const { return m_size; }
-    constexpr auto empty() const { return m_size == 0; }
+    constexpr auto size() const { return m_data.size(); }
+    constexpr auto empty() const { return m_data.empty(); }
 
   private:
     template <typename This>
@@ -112,15 +109,15 @@ namespace cx
                          [&k] (const auto &d) { return Compare{}(d.first, k); });
     }
 
-    template <typename This, typename K,
-              std::enable_if_t<has_is_transparent<Compare>::value, int> = 0>
+    template <typename This, typename K, typename C = Compare,
+              std::enable_if_t<has_is_transparent<C>::value, int> = 0>
     static constexpr auto find_impl(This &&t, const K &k)
     {
       return cx::find_if(t.begin(), t.end(),
                          [&k] (const auto &d) { return Compare{}(d.first, k); });
     }
 
-    std::array<cx::pair<Key, Value>, Size> m_data{}; // for constexpr use, the std::array must be initialized
-    std::size_t m_size{0};
+    // with a Size of dynamic_extent, the map can grow
+    cx::vector<cx::pair<Key, Value>, Size> m_data;
   };
 }
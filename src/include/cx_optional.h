@@ -1,35 +1,145 @@
 #pragma once
 
+#include "cx_config.h"
+
+#include <memory>
+#include <new>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace cx
 {
+  namespace detail
+  {
+    // The value lives in a union so that an empty optional never constructs a
+    // T: a failed parse costs a bool, not a default-constructed payload.
+
+    // For trivially copyable T (everything the parsers produce), the special
+    // members can all be defaulted, which keeps optional constexpr and
+    // trivially copyable in turn.
+    template <typename T, bool = std::is_trivially_copyable_v<T>>
+    struct optional_storage
+    {
+      constexpr optional_storage() : m_empty{} {}
+
+      template <typename... Args>
+      constexpr explicit optional_storage(std::in_place_t, Args&&... args)
+        : m_t(std::forward<Args>(args)...), m_valid(true)
+      {}
+
+      union
+      {
+        char m_empty;
+        T m_t;
+      };
+      bool m_valid = false;
+    };
+
+    // Otherwise the value has to be constructed and destroyed by hand, which
+    // is only allowed in constant expressions from C++20.
+    template <typename T>
+    struct optional_storage<T, false>
+    {
+      constexpr optional_storage() : m_empty{} {}
+
+      template <typename... Args>
+      constexpr explicit optional_storage(std::in_place_t, Args&&... args)
+        : m_t(std::forward<Args>(args)...), m_valid(true)
+      {}
+
+      CX_CONSTEXPR20 optional_storage(const optional_storage& other) : m_empty{}
+      {
+        if (other.m_valid) construct(other.m_t);
+      }
+
+      CX_CONSTEXPR20 optional_storage(optional_storage&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_empty{}
+      {
+        if (other.m_valid) construct(std::move(other.m_t));
+      }
+
+      CX_CONSTEXPR20 optional_storage& operator=(const optional_storage& other)
+      {
+        if (this != &other) {
+          reset();
+          if (other.m_valid) construct(other.m_t);
+        }
+        return *this;
+      }
+
+      CX_CONSTEXPR20 optional_storage& operator=(optional_storage&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+      {
+        if (this != &other) {
+          reset();
+          if (other.m_valid) construct(std::move(other.m_t));
+        }
+        return *this;
+      }
+
+      CX_CONSTEXPR20 ~optional_storage() { reset(); }
+
+      template <typename... Args>
+      CX_CONSTEXPR20 void construct(Args&&... args)
+      {
+#if CX_CONSTEXPR_ALLOCATION
+        std::construct_at(std::addressof(m_t), std::forward<Args>(args)...);
+#else
+        ::new (static_cast<void*>(std::addressof(m_t))) T(std::forward<Args>(args)...);
+#endif
+        m_valid = true;
+      }
+
+      CX_CONSTEXPR20 void reset()
+      {
+        if (m_valid) {
+          m_t.~T();
+          m_valid = false;
+        }
+      }
+
+      union
+      {
+        char m_empty;
+        T m_t;
+      };
+      bool m_valid = false;
+    };
+  }
+
   template <typename T>
-  struct optional
+  struct optional : private detail::optional_storage<T>
   {
     using value_type = T;
 
+    constexpr optional() = default;
     constexpr optional(std::nullopt_t) {}
     constexpr explicit optional(const T& t)
-      : m_valid(true), m_t(t)
+      : detail::optional_storage<T>(std::in_place, t)
+    {}
+    constexpr explicit optional(T&& t)
+      : detail::optional_storage<T>(std::in_place, std::move(t))
+    {}
+    template <typename... Args>
+    constexpr explicit optional(std::in_place_t, Args&&... args)
+      : detail::optional_storage<T>(std::in_place, std::forward<Args>(args)...)
     {}
 
-    constexpr explicit operator bool() const { return m_valid; }
-
-    constexpr const T* operator->() const { return &m_t; }
-    constexpr T* operator->() { return &m_t; }
-    constexpr const T& operator*() const { return m_t; }
-    constexpr T& operator*() { return m_t; }
+    constexpr explicit operator bool() const { return this->m_valid; }
+    constexpr bool has_value() const { return this->m_valid; }
 
-  private:
-    bool m_valid = false;
-    T m_t{};
+    constexpr const T* operator->() const { return std::addressof(this->m_t); }
+    constexpr T* operator->() { return std::addressof(this->m_t); }
+    constexpr const T& operator*() const & { return this->m_t; }
+    constexpr T& operator*() & { return this->m_t; }
+    constexpr T&& operator*() && { return std::move(this->m_t); }
   };
 
   template <typename T>
   constexpr auto make_optional(T&& t)
   {
-    return optional<T>(std::forward<T>(t));
+    return optional<std::decay_t<T>>(std::forward<T>(t));
   }
 }
@@ -3,6 +3,8 @@
 // necessary because std::pair seems to be disabling the move assignment for
 // some unclear reason. It's not clear if this is a bug in the gcc impl
 
+#include <utility>
+
 namespace cx
 {
   template <typename First, typename Second>
@@ -17,6 +19,6 @@ namespace cx
   template <typename First, typename Second>
   constexpr auto make_pair(First f, Second s)
   {
-    return pair<First, Second>{f, s};
+    return pair<First, Second>{std::move(f), std::move(s)};
   }
 }
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cx_algorithm.h>
 #include <cx_optional.h>
 #include <cx_pair.h>
 
+#include <array>
 #include <cstddef>
 #include <optional>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -19,8 +22,144 @@ namespace parser
   // A parser for T is a callable thing that takes a "string" and returns
   // (optionally) an T plus the "leftover string".
   using parse_input_t = std::string_view;
-  template <typename T>
-  using parse_result_t = cx::optional<cx::pair<T, std::string_view>>;
+  template <typename T, typename Input = parse_input_t>
+  using parse_result_t = cx::optional<cx::pair<T, Input>>;
+
+  // The "string" needn't be a std::string_view. An input is anything that,
+  // like std::string_view, has empty(), size() (the chars left) and front(),
+  // and for which these are overloaded:
+  //
+  //   drop(s, n)         - the input after its first n chars
+  //   skip_prefix(s, str) - the input after str, if it begins with str
+  //   position(s)        - where the input is (so that memo can key on it)
+  //
+  // The combinators and the char and string parsers below take any input,
+  // so a parser built from them does too (see rope_input, for segmented
+  // input). Contiguous input stays the fast path: for std::string_view these
+  // are the same pointer arithmetic as ever.
+
+  constexpr parse_input_t drop(parse_input_t s, std::size_t n)
+  {
+    return parse_input_t(s.data()+n, s.size()-n);
+  }
+
+  constexpr cx::optional<parse_input_t> skip_prefix(parse_input_t s,
+                                                    std::string_view str)
+  {
+    const auto p = cx::mismatch(str.cbegin(), str.cend(), s.cbegin(), s.cend());
+    if (p.first != str.cend()) return std::nullopt;
+    // std::distance is not constexpr?
+    const auto len = static_cast<std::string_view::size_type>(s.cend() - p.second);
+    return cx::optional<parse_input_t>(parse_input_t(p.second, len));
+  }
+
+  constexpr const char* position(parse_input_t s) { return s.data(); }
+
+  // Anything that converts to a std::string_view (a literal, a std::string)
+  // is parsed as one, as it was before parsers took other inputs. Inputs are
+  // taken by value, which is what keeps string_views in registers - so a
+  // std::string must be passed as a string_view: otherwise what's left of it
+  // after parsing would be a view of the parser's copy, gone on return.
+  namespace detail
+  {
+    template <typename Input, bool = std::is_convertible_v<const Input&, parse_input_t>>
+    struct input
+    {
+      using type = std::decay_t<Input>;
+    };
+
+    template <typename Input>
+    struct input<Input, true>
+    {
+      static_assert(std::is_trivially_copyable_v<std::decay_t<Input>>,
+                    "pass a string that owns its chars as a std::string_view");
+      using type = parse_input_t;
+    };
+  }
+
+  template <typename Input>
+  using input_t = typename detail::input<Input>::type;
+
+  template <typename Input>
+  constexpr input_t<Input> as_input(const Input& s) { return s; }
+
+  // A rope: input in segments (network buffers, say), parsed as though they
+  // were concatenated but without concatenating them, so tokens may straddle
+  // segments. Like a string_view, it doesn't own the segments, which must
+  // outlive it.
+  class rope_input
+  {
+  public:
+    constexpr rope_input() = default;
+    constexpr rope_input(const std::string_view* segments, std::size_t count)
+      : m_segments(segments), m_count(count)
+    {
+      for (std::size_t i = 0; i < count; ++i) m_size += segments[i].size();
+      normalize();
+    }
+    template <std::size_t N>
+    constexpr explicit rope_input(const std::string_view (&segments)[N])
+      : rope_input(segments, N)
+    {}
+
+    constexpr bool empty() const { return m_size == 0; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr char front() const { return m_segments[m_segment][m_offset]; }
+
+    // the contiguous chars at the front of the input
+    constexpr std::string_view chunk() const
+    {
+      if (empty()) return {};
+      const auto s = m_segments[m_segment];
+      return std::string_view(s.data() + m_offset, s.size() - m_offset);
+    }
+
+    friend constexpr rope_input drop(rope_input s, std::size_t n)
+    {
+      s.m_size -= n;
+      s.m_offset += n;
+      s.normalize();
+      return s;
+    }
+
+    friend constexpr cx::optional<rope_input> skip_prefix(rope_input s,
+                                                          std::string_view str)
+    {
+      if (str.size() > s.size()) return std::nullopt;
+      while (!str.empty()) {
+        const auto c = s.chunk();
+        const auto n = c.size() < str.size() ? c.size() : str.size();
+        if (!cx::equal(str.cbegin(), str.cbegin() + n, c.cbegin(), c.cbegin() + n)) {
+          return std::nullopt;
+        }
+        s = drop(s, n);
+        str.remove_prefix(n);
+      }
+      return cx::optional<rope_input>(s);
+    }
+
+    friend constexpr const char* position(const rope_input& s)
+    {
+      return s.empty() ? nullptr : s.chunk().data();
+    }
+
+  private:
+    // move past the ends of segments (and past empty segments), so that
+    // front() is in the current segment
+    constexpr void normalize()
+    {
+      while (m_segment < m_count && m_offset >= m_segments[m_segment].size()) {
+        m_offset -= m_segments[m_segment].size();
+        ++m_segment;
+      }
+    }
+
+    const std::string_view* m_segments = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_segment = 0;
+    std::size_t m_offset = 0;
+    std::size_t m_size = 0;
+  };
 
   // Get various types out of a parser
   template <typename P>
@@ -37,24 +176,25 @@ namespace parser
   template <typename F, typename P>
   constexpr auto fmap(F&& f, P&& p)
   {
-    using R = parse_result_t<std::result_of_t<F(parse_t<P>)>>;
+    using T = std::result_of_t<F(parse_t<P>)>;
     return [f = std::forward<F>(f),
-            p = std::forward<P>(p)] (parse_input_t i) -> R {
-             const auto r = p(i);
+            p = std::forward<P>(p)] (auto i) -> parse_result_t<T, input_t<decltype(i)>> {
+             using R = parse_result_t<T, input_t<decltype(i)>>;
+             auto r = p(i);
              if (!r) return std::nullopt;
-             return R(cx::make_pair(f(r->first), r->second));
+             return R(cx::make_pair(f(std::move(r->first)), r->second));
            };
   }
 
-  // bind a function into a parser. F :: (parse_t<P>, parse_input_t) -> a
+  // bind a function into a parser. F :: (parse_t<P>, input) -> a
   template <typename P, typename F>
   constexpr auto bind(P&& p, F&& f)
   {
-    using R = std::result_of_t<F(parse_t<P>, parse_input_t)>;
-    return [=] (parse_input_t i) -> R {
-             const auto r = p(i);
+    return [=] (auto i)
+      -> std::invoke_result_t<const F&, parse_t<P>, input_t<decltype(i)>> {
+             auto r = p(i);
              if (!r) return std::nullopt;
-             return f(r->first, r->second);
+             return f(std::move(r->first), r->second);
            };
   }
 
@@ -62,9 +202,9 @@ namespace parser
   template <typename T>
   constexpr auto lift(T&& t)
   {
-    return [t = std::forward<T>(t)] (parse_input_t s) {
-             return parse_result_t<T>(
-                 cx::make_pair(std::move(t), s));
+    return [t = std::forward<T>(t)] (auto s) {
+             return parse_result_t<T, input_t<decltype(s)>>(
+                 cx::make_pair(std::move(t), as_input(s)));
            };
   }
 
@@ -72,7 +212,7 @@ namespace parser
   template <typename T>
   constexpr auto fail(T)
   {
-    return [=] (parse_input_t) -> parse_result_t<T> {
+    return [=] ([[maybe_unused]] auto i) -> parse_result_t<T, input_t<decltype(i)>> {
       return std::nullopt;
     };
   }
@@ -80,7 +220,7 @@ namespace parser
   template <typename T, typename ErrorFn>
   constexpr auto fail(T, ErrorFn f)
   {
-    return [=] (parse_input_t) -> parse_result_t<T> {
+    return [=] ([[maybe_unused]] auto i) -> parse_result_t<T, input_t<decltype(i)>> {
       f();
       return std::nullopt;
     };
@@ -94,25 +234,96 @@ namespace parser
   template <typename P1, typename P2,
             typename = std::enable_if_t<std::is_same_v<parse_t<P1>, parse_t<P2>>>>
   constexpr auto operator|(P1&& p1, P2&& p2) {
-    return [=] (parse_input_t i) {
-             const auto r1 = p1(i);
+    return [=] (auto i) {
+             auto r1 = p1(i);
              if (r1) return r1;
              return p2(i);
            };
   }
 
+  // first-character dispatch: an alternative to a chain of alternations when
+  // the first char of the input decides which alternative can match. Each arm
+  // pairs a set of chars with a parser; a 256-entry table maps the first char
+  // straight to its arm, so only that parser is run. An arm is chosen by the
+  // first char alone, with no fallback: where the char sets overlap, the
+  // char goes to the earlier arm, and if that arm's parser fails, so does
+  // the dispatch - unlike |, a later arm is never tried. All the parsers
+  // must return the same type.
+  template <typename P>
+  struct dispatch_arm
+  {
+    std::string_view chars;
+    P p;
+  };
+
+  template <typename P>
+  constexpr auto arm(std::string_view chars, P&& p)
+  {
+    return dispatch_arm<std::decay_t<P>>{chars, std::forward<P>(p)};
+  }
+
+  namespace detail
+  {
+    // table entries are the arm index + 1; 0 means no arm starts with the char
+    using dispatch_table_t = std::array<unsigned char, 256>;
+
+    template <typename... Ps>
+    constexpr dispatch_table_t make_dispatch_table(const dispatch_arm<Ps>&... arms)
+    {
+      static_assert(sizeof...(Ps) < 256, "too many dispatch arms");
+      dispatch_table_t table{};
+      const std::string_view sets[] = { arms.chars... };
+      for (std::size_t i = 0; i < sizeof...(Ps); ++i) {
+        for (const auto c : sets[i]) {
+          auto& t = table[static_cast<unsigned char>(c)];
+          if (t == 0) t = static_cast<unsigned char>(i + 1);
+        }
+      }
+      return table;
+    }
+
+    template <std::size_t I, typename R, typename Tuple, typename Input>
+    constexpr R dispatch_to(const Tuple& ps, std::size_t n, const Input& s)
+    {
+      if constexpr (I == std::tuple_size_v<Tuple>) {
+        return std::nullopt;
+      } else {
+        if (n == I) return std::get<I>(ps)(s);
+        return dispatch_to<I+1, R>(ps, n, s);
+      }
+    }
+  }
+
+  template <typename P, typename... Ps>
+  constexpr auto dispatch(dispatch_arm<P> a, dispatch_arm<Ps>... arms)
+  {
+    static_assert((std::is_same_v<parse_t<P>, parse_t<Ps>> && ...),
+                  "dispatch arms must all return the same type");
+    return [table = detail::make_dispatch_table(a, arms...),
+            ps = std::tuple<P, Ps...>(std::move(a.p), std::move(arms.p)...)] (
+                auto in) -> parse_result_t<parse_t<P>, input_t<decltype(in)>> {
+             using R = parse_result_t<parse_t<P>, input_t<decltype(in)>>;
+             const auto s = as_input(in);
+             if (s.empty()) return std::nullopt;
+             const auto n = table[static_cast<unsigned char>(s.front())];
+             if (n == 0) return std::nullopt;
+             return detail::dispatch_to<0, R>(ps, n - 1u, s);
+           };
+  }
+
   // accumulation: run two parsers in sequence and combine the outputs using the
   // given function. Both parsers must succeed.
   template <typename P1, typename P2, typename F,
             typename R = std::result_of_t<F(parse_t<P1>, parse_t<P2>)>>
   constexpr auto combine(P1&& p1, P2&& p2, F&& f) {
-    return [=] (parse_input_t i) -> parse_result_t<R> {
-             const auto r1 = p1(i);
+    return [=] (auto i) -> parse_result_t<R, input_t<decltype(i)>> {
+             auto r1 = p1(i);
              if (!r1) return std::nullopt;
-             const auto r2 = p2(r1->second);
+             auto r2 = p2(r1->second);
              if (!r2) return std::nullopt;
-             return parse_result_t<R>(
-                 cx::make_pair(f(r1->first, r2->first), r2->second));
+             return parse_result_t<R, input_t<decltype(i)>>(
+                 cx::make_pair(f(std::move(r1->first), std::move(r2->first)),
+                               r2->second));
            };
   }
 
@@ -123,7 +334,7 @@ namespace parser
   constexpr auto operator<(P1&& p1, P2&& p2) {
     return combine(std::forward<P1>(p1),
                    std::forward<P2>(p2),
-                   [] (auto, const auto& r) { return r; });
+                   [] (auto&&, auto r) { return r; });
   }
 
   template <typename P1, typename P2,
@@ -131,16 +342,17 @@ namespace parser
   constexpr auto operator>(P1&& p1, P2&& p2) {
     return combine(std::forward<P1>(p1),
                    std::forward<P2>(p2),
-                   [] (const auto& r, auto) { return r; });
+                   [] (auto r, auto&&) { return r; });
   }
 
-  // apply ? (zero or one) of a parser
+  // apply ? (zero or one) of a parser. Its result is a view of the input, so
+  // this one needs contiguous input.
   template <typename P>
   constexpr auto zero_or_one(P&& p)
   {
     using R = parse_result_t<parse_input_t>;
     return [p = std::forward<P>(p)] (parse_input_t s) -> R {
-             const auto r = p(s);
+             auto r = p(s);
              if (r) return r;
              return R(cx::make_pair(parse_input_t(s.data(), 0), s));
            };
@@ -148,69 +360,86 @@ namespace parser
 
   namespace detail
   {
-    template <typename P, typename T, typename F>
-    constexpr cx::pair<T, parse_input_t> accumulate_parse(
-        parse_input_t s, P&& p, T init, F&& f)
+    // An accumulating function may either return the new accumulator
+    // (F :: T -> a -> T), in which case the accumulator is moved through it,
+    // or update the accumulator in place (F :: T& -> a -> void). The second
+    // form never copies the accumulator, which matters when it is large (a
+    // string, say) and trivially copyable, so that moving it is copying it.
+    template <typename T, typename F, typename X>
+    constexpr void accumulate(T& acc, F&& f, X&& x)
+    {
+      if constexpr (std::is_void_v<std::invoke_result_t<F, T&, X>>) {
+        f(acc, std::forward<X>(x));
+      } else {
+        acc = f(std::move(acc), std::forward<X>(x));
+      }
+    }
+
+    template <typename Input, typename P, typename T, typename F>
+    constexpr cx::pair<T, Input> accumulate_parse(
+        Input s, P&& p, T init, F&& f)
     {
       while (!s.empty()) {
-        const auto r = p(s);
-        if (!r) return cx::make_pair(init, s);
-        init = f(init, r->first);
+        auto r = p(s);
+        if (!r) return cx::make_pair(std::move(init), s);
+        accumulate(init, f, std::move(r->first));
         s = r->second;
       }
-      return cx::make_pair(init, s);
+      return cx::make_pair(std::move(init), s);
     }
 
-    template <typename P, typename T, typename F>
-    constexpr cx::pair<T, parse_input_t> accumulate_n_parse(
-        parse_input_t s, P&& p, std::size_t n, T init, F&& f)
+    template <typename Input, typename P, typename T, typename F>
+    constexpr cx::pair<T, Input> accumulate_n_parse(
+        Input s, P&& p, std::size_t n, T init, F&& f)
     {
       while (n != 0) {
-        const auto r = p(s);
-        if (!r) return cx::make_pair(init, s);
-        init = f(init, r->first);
+        auto r = p(s);
+        if (!r) return cx::make_pair(std::move(init), s);
+        accumulate(init, f, std::move(r->first));
         s = r->second;
         --n;
       }
-      return cx::make_pair(init, s);
+      return cx::make_pair(std::move(init), s);
     }
   }
 
   // apply * (zero or more) of a parser, accumulating the results according to a
-  // function F. F :: T -> (parse_t<P>, parse_input_t) -> T
+  // function F. F :: T -> parse_t<P> -> T (or T& -> parse_t<P> -> void)
   template <typename P, typename T, typename F>
   constexpr auto many(P&& p, T&& init, F&& f)
   {
     return [p = std::forward<P>(p), init = std::forward<T>(init),
-            f = std::forward<F>(f)] (parse_input_t s) {
-             return parse_result_t<T>(
-                 detail::accumulate_parse(s, p, init, f));
+            f = std::forward<F>(f)] (auto s) {
+             return parse_result_t<T, input_t<decltype(s)>>(
+                 detail::accumulate_parse(as_input(s), p, init, f));
            };
   }
 
   // apply + (one or more) of a parser, accumulating the results according to a
-  // function F. F :: T -> (parse_t<P>, parse_input_t) -> T
+  // function F. F :: T -> parse_t<P> -> T (or T& -> parse_t<P> -> void)
   template <typename P, typename T, typename F>
   constexpr auto many1(P&& p, T&& init, F&& f)
   {
     return [p = std::forward<P>(p), init = std::forward<T>(init),
-            f = std::forward<F>(f)] (parse_input_t s) -> parse_result_t<T> {
-      const auto r = p(s);
+            f = std::forward<F>(f)] (auto s) -> parse_result_t<T, input_t<decltype(s)>> {
+      auto r = p(s);
       if (!r) return std::nullopt;
-      return parse_result_t<T>(
-          detail::accumulate_parse(r->second, p, f(init, r->first), f));
+      auto acc = init;
+      detail::accumulate(acc, f, std::move(r->first));
+      return parse_result_t<T, input_t<decltype(s)>>(
+          detail::accumulate_parse(r->second, p, std::move(acc), f));
     };
   }
 
   // apply a parser exactly n times, accumulating the results according to a
-  // function F. F :: T -> (parse_t<P>, parse_input_t) -> T
+  // function F. F :: T -> parse_t<P> -> T (or T& -> parse_t<P> -> void)
   template <typename P, typename T, typename F>
   constexpr auto exactly_n(P&& p, std::size_t n, T&& init, F&& f)
   {
     return [p = std::forward<P>(p), n, init = std::forward<T>(init),
-            f = std::forward<F>(f)] (parse_input_t s) {
-             return parse_result_t<T>(
-                 detail::accumulate_n_parse(s, p, n, init, f));
+            f = std::forward<F>(f)] (auto s) {
+             return parse_result_t<T, input_t<decltype(s)>>(
+                 detail::accumulate_n_parse(as_input(s), p, n, init, f));
            };
   }
 
@@ -219,10 +448,10 @@ namespace parser
   constexpr auto option(T&& def, P&& p)
   {
     return [p = std::forward<P>(p),
-            def = std::forward<T>(def)] (parse_input_t s) {
-             const auto r = p(s);
+            def = std::forward<T>(def)] (auto s) {
+             auto r = p(s);
              if (r) return r;
-             return parse_result_t<T>(cx::make_pair(def, s));
+             return parse_result_t<T, input_t<decltype(s)>>(cx::make_pair(def, as_input(s)));
            };
   }
 
@@ -234,12 +463,12 @@ namespace parser
     using T = parse_t<P1>;
     return [p1 = std::forward<P1>(p1), p2 = std::forward<P2>(p2),
             f = std::forward<F>(f)] (
-                parse_input_t s) -> parse_result_t<T> {
-             const auto r = p1(s);
+                auto s) -> parse_result_t<T, input_t<decltype(s)>> {
+             auto r = p1(s);
              if (!r) return std::nullopt;
              const auto p = p2 < p1;
-             return parse_result_t<T>(
-                 detail::accumulate_parse(r->second, p, r->first, f));
+             return parse_result_t<T, input_t<decltype(s)>>(
+                 detail::accumulate_parse(r->second, p, std::move(r->first), f));
            };
   }
 
@@ -248,14 +477,17 @@ namespace parser
   template <typename P1, typename P2, typename F0, typename F>
   constexpr auto separated_by(P1&& p1, P2&& p2, F0&& init, F&& f)
   {
-    using R = parse_result_t<std::result_of_t<F0()>>;
+    using T = std::result_of_t<F0()>;
     return [p1 = std::forward<P1>(p1), p2 = std::forward<P2>(p2),
             init = std::forward<F0>(init), f = std::forward<F>(f)] (
-                parse_input_t s) -> R {
-      const auto r = p1(s);
-      if (!r) return R(cx::make_pair(init(), s));
+                auto s) -> parse_result_t<T, input_t<decltype(s)>> {
+      using R = parse_result_t<T, input_t<decltype(s)>>;
+      auto r = p1(s);
+      if (!r) return R(cx::make_pair(init(), as_input(s)));
       const auto p = p2 < p1;
-      return R(detail::accumulate_parse(r->second, p, f(init(), r->first), f));
+      auto acc = init();
+      detail::accumulate(acc, f, std::move(r->first));
+      return R(detail::accumulate_parse(r->second, p, std::move(acc), f));
     };
   }
 
@@ -264,40 +496,106 @@ namespace parser
   template <typename P1, typename P2, typename T, typename F>
   constexpr auto separated_by_val(P1&& p1, P2&& p2, T&& init, F&& f)
   {
-    using R = parse_result_t<std::remove_reference_t<T>>;
+    using U = std::remove_reference_t<T>;
     return [p1 = std::forward<P1>(p1), p2 = std::forward<P2>(p2),
             init = std::forward<T>(init), f = std::forward<F>(f)] (
-                parse_input_t s) -> R {
-      const auto r = p1(s);
-      if (!r) return R(cx::make_pair(init, s));
+                auto s) -> parse_result_t<U, input_t<decltype(s)>> {
+      using R = parse_result_t<U, input_t<decltype(s)>>;
+      auto r = p1(s);
+      if (!r) return R(cx::make_pair(init, as_input(s)));
       const auto p = p2 < p1;
-      return R(detail::accumulate_parse(r->second, p, f(init, r->first), f));
+      auto acc = init;
+      detail::accumulate(acc, f, std::move(r->first));
+      return R(detail::accumulate_parse(r->second, p, std::move(acc), f));
     };
   }
 
+  //----------------------------------------------------------------------------
+  // memoization (packrat parsing)
+
+  // A memo_table is a bounded cache of parse results keyed by input
+  // position. Since all the inputs seen during one parse share the same end,
+  // the remaining size identifies the position: it picks the slot (so the
+  // table is direct-mapped) and position() confirms the hit. A table
+  // should be used for one input at a time; clear() it before parsing a
+  // different buffer.
+  template <typename T, std::size_t N = 16, typename Input = parse_input_t>
+  struct memo_table
+  {
+    static_assert(N > 0, "memo_table needs at least one slot");
+    using value_type = T;
+    using input_type = Input;
+
+    struct entry
+    {
+      bool valid = false;
+      const char* pos = nullptr;
+      std::size_t size = 0;
+      parse_result_t<T, Input> result = std::nullopt;
+    };
+
+    constexpr entry& slot(const Input& s) { return m_entries[s.size() % N]; }
+
+    constexpr void clear()
+    {
+      for (auto& e : m_entries) e.valid = false;
+    }
+
+    std::array<entry, N> m_entries{};
+  };
+
+  // memoize a parser. The combinators copy parsers by value, so the cache is
+  // held by reference: every copy of the memoized parser (e.g. in both arms
+  // of an alternation) shares the same table. In constant evaluation the
+  // table must be created during the evaluation, just like any other storage
+  // the parsers write to.
+  template <typename P, typename T, std::size_t N, typename Input>
+  constexpr auto memo(P&& p, memo_table<T, N, Input>& table)
+  {
+    static_assert(std::is_same_v<parse_t<P>, T>,
+                  "memo_table value_type must match the parser");
+    using R = parse_result_t<T, Input>;
+    return [p = std::forward<P>(p), &table] (auto in) -> R {
+             static_assert(std::is_same_v<input_t<decltype(in)>, Input>,
+                           "memo_table input_type must match the input");
+             const Input s = in;
+             auto& e = table.slot(s);
+             if (e.valid && e.size == s.size() && e.pos == position(s)) {
+               return e.result;
+             }
+             auto r = p(s);
+             e.valid = true;
+             e.pos = position(s);
+             e.size = s.size();
+             e.result = r;
+             return r;
+           };
+  }
+
   //----------------------------------------------------------------------------
   // parsers for various types
 
   // parse a given char
   constexpr auto make_char_parser(char c)
   {
-    return [=] (parse_input_t s) -> parse_result_t<char> {
-      if (s.empty() || s[0] != c) return std::nullopt;
-      return parse_result_t<char>(
-          cx::make_pair(c, parse_input_t(s.data()+1, s.size()-1)));
+    return [=] (auto in) -> parse_result_t<char, input_t<decltype(in)>> {
+      const auto s = as_input(in);
+      if (s.empty() || s.front() != c) return std::nullopt;
+      return parse_result_t<char, input_t<decltype(in)>>(cx::make_pair(c, drop(s, 1)));
     };
   }
 
   // parse one of a set of chars
   constexpr auto one_of(std::string_view chars)
   {
-    return [=] (parse_input_t s) -> parse_result_t<char> {
+    return [=] (auto in) -> parse_result_t<char, input_t<decltype(in)>> {
+      const auto s = as_input(in);
       if (s.empty()) return std::nullopt;
       // basic_string_view::find is supposed to be constexpr, but no...
-      auto j = cx::find(chars.cbegin(), chars.cend(), s[0]);
+      const char c = s.front();
+      auto j = cx::find(chars.cbegin(), chars.cend(), c);
       if (j != chars.cend()) {
-        return parse_result_t<char>(
-            cx::make_pair(s[0], parse_input_t(s.data()+1, s.size()-1)));
+        return parse_result_t<char, input_t<decltype(in)>>(cx::make_pair(c, drop(s, 1)));
       }
       return std::nullopt;
     };
@@ -306,13 +604,14 @@ namespace parser
   // parse none of a set of chars
   constexpr auto none_of(std::string_view chars)
   {
-    return [=] (parse_input_t s) -> parse_result_t<char> {
+    return [=] (auto in) -> parse_result_t<char, input_t<decltype(in)>> {
+      const auto s = as_input(in);
       if (s.empty()) return std::nullopt;
       // basic_string_view::find is supposed to be constexpr, but no...
-      auto j = cx::find(chars.cbegin(), chars.cend(), s[0]);
+      const char c = s.front();
+      auto j = cx::find(chars.cbegin(), chars.cend(), c);
       if (j == chars.cend()) {
-        return parse_result_t<char>(
-            cx::make_pair(s[0], parse_input_t(s.data()+1, s.size()-1)));
+        return parse_result_t<char, input_t<decltype(in)>>(cx::make_pair(c, drop(s, 1)));
       }
       return std::nullopt;
     };
@@ -321,16 +620,11 @@ namespace parser
   // parse a given string
   constexpr auto make_string_parser(std::string_view str)
   {
-    return [=] (parse_input_t s) -> parse_result_t<std::string_view> {
-      const auto p = cx::mismatch(str.cbegin(), str.cend(), s.cbegin(), s.cend());
-      if (p.first == str.cend()) {
-        // std::distance is not constexpr?
-        const auto len = static_cast<std::string_view::size_type>(
-            s.cend() - p.second);
-        return parse_result_t<std::string_view>(
-            cx::make_pair(str, parse_input_t(p.second, len)));
-      }
-      return std::nullopt;
+    return [=] (auto s) -> parse_result_t<std::string_view, input_t<decltype(s)>> {
+      auto rest = skip_prefix(as_input(s), str);
+      if (!rest) return std::nullopt;
+      return parse_result_t<std::string_view, input_t<decltype(s)>>(
+          cx::make_pair(str, std::move(*rest)));
     };
   }
 
@@ -348,7 +642,7 @@ namespace parser
   {
     using namespace std::literals;
     return bind(one_of("123456789"sv),
-                [] (char x, parse_input_t rest) {
+                [] (char x, auto rest) {
                   return many(one_of("0123456789"sv),
                               static_cast<int>(x - '0'),
                               [] (int acc, char c) { return (acc*10) + (c-'0'); })(rest);
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "cx_algorithm.h"
+#include "cx_pair.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace cx
+{
+  // FNV-1a over the chars of a string (anything with begin and end), or the
+  // bytes of an integer. Integers are hashed as 64 bits whatever their type,
+  // so that a key can be looked up with an integer of another type. As with
+  // value_proxy::StringCompare, a char array's length includes the null
+  // terminator, so we leave that out.
+  struct static_hash
+  {
+    template <typename S>
+    constexpr std::uint64_t operator()(const S& s) const
+    {
+      std::uint64_t h = 14695981039346656037ull;
+      if constexpr (std::is_integral_v<S>) {
+        auto u = static_cast<std::uint64_t>(s);
+        for (std::size_t i = 0; i < sizeof(std::uint64_t); ++i, u >>= 8) {
+          h = (h ^ (u & 0xff)) * 1099511628211ull;
+        }
+      } else {
+        for (auto c : s) {
+          h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+      }
+      return h;
+    }
+
+    template <std::size_t N>
+    constexpr std::uint64_t operator()(const char (&s)[N]) const
+    {
+      return (*this)(std::string_view(s, N-1));
+    }
+  };
+
+  // the equality that goes with static_hash
+  struct static_equal
+  {
+    template <typename S1, typename S2>
+    constexpr bool operator()(const S1& s1, const S2& s2) const
+    {
+      if constexpr (std::is_integral_v<S1>) {
+        return s1 == s2;
+      } else {
+        return cx::equal(std::cbegin(s1), std::cend(s1),
+                         std::cbegin(s2), std::cend(s2));
+      }
+    }
+
+    template <typename S1, std::size_t N>
+    constexpr bool operator()(const S1& s1, const char (&s2)[N]) const
+    {
+      return (*this)(s1, std::string_view(s2, N-1));
+    }
+  };
+
+  // A static_unordered_map is a fixed table built at compile time with a
+  // minimal perfect hash (using "hash and displace"): the N keys hash into N
+  // buckets, and each bucket records how to reach its keys' slots among the N
+  // entries - either directly (a bucket with one key), or by rehashing with a
+  // displacement chosen so that none of its keys collide. Looking up a key is
+  // then one hash, one probe of the bucket table, and one key comparison.
+  template <typename Key, typename Value, std::size_t N,
+            typename Hash = static_hash, typename KeyEqual = static_equal>
+  class static_unordered_map
+  {
+    static_assert(N > 0, "static_unordered_map needs at least one entry");
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = cx::pair<Key, Value>;
+
+    constexpr explicit static_unordered_map(const value_type (&items)[N])
+    {
+      // sort the keys by bucket (a counting sort)
+      std::uint64_t hashes[N]{};
+      std::size_t bucket_start[N+1]{};
+      std::size_t order[N]{};
+      for (std::size_t i = 0; i < N; ++i) {
+        hashes[i] = Hash{}(items[i].first);
+        ++bucket_start[bucket_of(hashes[i]) + 1];
+      }
+      std::size_t max_bucket = 0;
+      for (std::size_t b = 0; b < N; ++b) {
+        if (bucket_start[b+1] > max_bucket) max_bucket = bucket_start[b+1];
+        bucket_start[b+1] += bucket_start[b];
+      }
+      {
+        std::size_t next[N]{};
+        for (std::size_t i = 0; i < N; ++i) {
+          const auto b = bucket_of(hashes[i]);
+          order[bucket_start[b] + next[b]++] = i;
+        }
+      }
+
+      // place the biggest buckets first, while the table is emptiest
+      bool taken[N]{};
+      std::size_t tried[N]{};
+      std::size_t attempt = 0;
+      std::size_t free_slot = 0;
+      for (auto bucket_size = max_bucket; bucket_size > 0; --bucket_size) {
+        for (std::size_t b = 0; b < N; ++b) {
+          const auto first = bucket_start[b];
+          const auto last = bucket_start[b+1];
+          if (last - first != bucket_size) continue;
+
+          if (bucket_size == 1) {
+            while (taken[free_slot]) ++free_slot;
+            place(items[order[first]], free_slot, taken);
+            m_displace[b] = free_slot;
+            continue;
+          }
+
+          for (auto i = first; i < last; ++i) {
+            for (auto j = i + 1; j < last; ++j) {
+              if (hashes[order[i]] == hashes[order[j]]) {
+                throw std::runtime_error("Duplicate key in static_unordered_map");
+              }
+            }
+          }
+
+          for (std::size_t d = 1; ; ++d) {
+            if (d > max_displacement) {
+              throw std::runtime_error("Could not build a perfect hash");
+            }
+            ++attempt;
+            bool fits = true;
+            for (auto i = first; fits && i < last; ++i) {
+              const auto s = slot_for(hashes[order[i]], d);
+              fits = !taken[s] && tried[s] != attempt;
+              tried[s] = attempt;
+            }
+            if (fits) {
+              for (auto i = first; i < last; ++i) {
+                place(items[order[i]], slot_for(hashes[order[i]], d), taken);
+              }
+              m_displace[b] = N + d;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    constexpr auto begin() const { return m_data.begin(); }
+    constexpr auto begin() { return m_data.begin(); }
+    constexpr auto end() const { return m_data.end(); }
+    constexpr auto end() { return m_data.end(); }
+    constexpr auto cbegin() const { return m_data.cbegin(); }
+    constexpr auto cend() const { return m_data.cend(); }
+
+    template <typename K>
+    constexpr auto find(const K &k) const { return find_impl(*this, k); }
+    template <typename K>
+    constexpr auto find(const K &k) { return find_impl(*this, k); }
+
+    template <typename K>
+    constexpr bool contains(const K &k) const { return find(k) != end(); }
+
+    template <typename K>
+    constexpr const Value &at(const K &k) const
+    {
+      const auto itr = find(k);
+      if (itr != end()) { return itr->second; }
+      else { throw std::range_error("Key not found"); }
+    }
+
+    constexpr std::size_t size() const { return N; }
+    constexpr bool empty() const { return false; }
+
+  private:
+    static constexpr std::size_t max_displacement = std::size_t{1} << 20;
+
+    static constexpr std::size_t bucket_of(std::uint64_t h)
+    {
+      return static_cast<std::size_t>(h % N);
+    }
+
+    // rehash for a displacement d (with the splitmix64 finalizer)
+    static constexpr std::size_t slot_for(std::uint64_t h, std::size_t d)
+    {
+      auto x = h + d * 0x9e3779b97f4a7c15ull;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      x = x ^ (x >> 31);
+      return static_cast<std::size_t>(x % N);
+    }
+
+    constexpr void place(const value_type &v, std::size_t slot, bool (&taken)[N])
+    {
+      m_data[slot] = v;
+      taken[slot] = true;
+    }
+
+    template <typename This, typename K>
+    static constexpr auto find_impl(This &&t, const K &k)
+    {
+      const auto h = Hash{}(k);
+      const auto d = t.m_displace[bucket_of(h)];
+      const auto itr = t.begin() + (d < N ? d : slot_for(h, d - N));
+      return KeyEqual{}(itr->first, k) ? itr : t.end();
+    }
+
+    std::array<value_type, N> m_data{};
+    // per bucket: the slot of its only key (< N), or N + its displacement
+    std::array<std::size_t, N> m_displace{};
+  };
+
+  template <typename Key, typename Value, std::size_t N>
+  constexpr auto make_static_unordered_map(const cx::pair<Key, Value> (&items)[N])
+  {
+    return static_unordered_map<Key, Value, N>(items);
+  }
+}
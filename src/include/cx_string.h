@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <string_view>
 
+#include "cx_config.h"
 #include "cx_vector.h"
 
 namespace cx
@@ -47,6 +48,29 @@ namespace cx
     return cx::equal(x.begin(), x.end(), y.begin(), y.end());
   }
 
+  // A string held by value, so that (with C++20) a string literal can be a
+  // template argument: template <cx::fixed_string S> ... f<"hello">(). The
+  // members are public because template arguments must be.
+  template <std::size_t N>
+  struct fixed_string
+  {
+    constexpr fixed_string(const char (&str)[N])
+    {
+      for (std::size_t i = 0; i < N; ++i) m_data[i] = str[i];
+    }
+
+    constexpr std::size_t size() const { return N - 1; }
+    constexpr const char *data() const { return m_data; }
+    constexpr const char *begin() const { return m_data; }
+    constexpr const char *end() const { return m_data + N - 1; }
+    constexpr std::string_view view() const { return {m_data, N - 1}; }
+
+    char m_data[N]{};
+  };
+
+  template <std::size_t N>
+  fixed_string(const char (&)[N]) -> fixed_string<N>;
+
 
   // note that this works because vector is implicitly null terminated with its data initializer
   template<typename CharType, size_t Size>
@@ -71,9 +95,14 @@ namespace cx
       return *this = basic_string(s);
     }
 
-    constexpr const char *c_str() const {
-      return this->data();
+    constexpr const CharType *c_str() const {
+      // a growable string has no storage until something is put in it
+      const auto d = this->data();
+      return d ? d : &s_empty;
     }
+
+  private:
+    static constexpr CharType s_empty{};
   };
 
   template<typename CharType, size_t Size>
@@ -84,5 +113,11 @@ namespace cx
 
   using string = basic_string<char, 32>;
 
+  // A string_builder is a string without a fixed capacity (see the growable
+  // vector). At compile time (with C++20) it is for building temporaries,
+  // e.g. parsing a string of unknown length and then measuring or copying it
+  // out.
+  using string_builder = basic_string<char, dynamic_extent>;
+
 
 }
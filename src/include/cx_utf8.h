@@ -0,0 +1,383 @@
+#pragma once
+
+#include "algorithms/cx_simd.h"
+#include "cx_config.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+// UTF-8 validation, cheap enough to do while text is being copied (e.g. the
+// strings in JSON).
+//
+// In constant evaluation (and wherever there's nothing faster) this is a
+// table-driven DFA. At runtime on x86 it checks 16 bytes at a time with the
+// lookup algorithm of Keiser and Lemire ("Validating UTF-8 in less than one
+// instruction per byte"): three table lookups (pshufb, so SSSE3) classify
+// each pair of adjacent bytes, and the only other checks are for the third
+// and fourth bytes of longer sequences. Unless the compiler may assume SSSE3,
+// whether the CPU has it is checked the first time it's needed.
+
+#if CX_SIMD_SSE2 && (defined(__x86_64__) || defined(__i386__))
+#define CX_UTF8_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define CX_UTF8_SSSE3 0
+#endif
+
+namespace cx
+{
+  namespace detail
+  {
+    // The DFA. Bytes are grouped into classes:
+    //   0: 00-7F   1: 80-8F   2: 90-9F   3: A0-BF (continuations by range)
+    //   4: C0-C1, F5-FF (never valid)
+    //   5: C2-DF   6: E0   7: E1-EC, EE-EF   8: ED   9: F0   10: F1-F3   11: F4
+    // and the states are
+    //   0: accept (between sequences)   1: reject
+    //   2, 3, 4: expecting 1, 2, 3 more continuations
+    //   5, 6, 7, 8: after E0, ED, F0, F4 (whose next byte is restricted, to
+    //   rule out overlong forms, surrogates and code points past 10FFFF)
+    inline constexpr std::size_t utf8_num_classes = 12;
+    inline constexpr std::size_t utf8_num_states = 9;
+
+    constexpr std::array<unsigned char, 256> make_utf8_classes()
+    {
+      std::array<unsigned char, 256> t{};
+      for (std::size_t b = 0; b < 256; ++b) {
+        t[b] = b < 0x80 ? 0 : b < 0x90 ? 1 : b < 0xa0 ? 2 : b < 0xc0 ? 3
+          : b < 0xc2 ? 4 : b < 0xe0 ? 5 : b == 0xe0 ? 6 : b == 0xed ? 8
+          : b < 0xf0 ? 7 : b == 0xf0 ? 9 : b < 0xf4 ? 10 : b == 0xf4 ? 11 : 4;
+      }
+      return t;
+    }
+
+    constexpr std::array<unsigned char, utf8_num_states * utf8_num_classes>
+    make_utf8_transitions()
+    {
+      std::array<unsigned char, utf8_num_states * utf8_num_classes> t{};
+      for (auto& s : t) s = 1;
+      const auto set = [&t] (std::size_t state, std::size_t c, unsigned char next) {
+        t[state * utf8_num_classes + c] = next;
+      };
+      set(0, 0, 0);
+      set(0, 5, 2);
+      set(0, 6, 5);
+      set(0, 7, 3);
+      set(0, 8, 6);
+      set(0, 9, 7);
+      set(0, 10, 4);
+      set(0, 11, 8);
+      for (std::size_t c = 1; c <= 3; ++c) {
+        set(2, c, 0);
+        set(3, c, 2);
+        set(4, c, 3);
+      }
+      set(5, 3, 2);
+      set(6, 1, 2);
+      set(6, 2, 2);
+      set(7, 2, 3);
+      set(7, 3, 3);
+      set(8, 1, 3);
+      return t;
+    }
+
+    inline constexpr auto utf8_classes = make_utf8_classes();
+    inline constexpr auto utf8_transitions = make_utf8_transitions();
+  }
+
+  // Validates UTF-8 a char at a time, so that it can be fed as text is
+  // consumed.
+  class utf8_validator
+  {
+  public:
+    constexpr void feed(char c)
+    {
+      m_state = detail::utf8_transitions[
+          m_state * detail::utf8_num_classes
+          + detail::utf8_classes[static_cast<unsigned char>(c)]];
+    }
+
+    // whether what has been fed is valid and complete
+    constexpr bool valid() const { return m_state == 0; }
+    // whether it's invalid, whatever comes next
+    constexpr bool failed() const { return m_state == 1; }
+
+  private:
+    std::size_t m_state = 0;
+  };
+
+  // the result of copy_until
+  struct utf8_run
+  {
+    std::size_t size;
+    bool valid;
+  };
+
+  namespace detail
+  {
+    template <bool Validate>
+    constexpr utf8_run copy_until_dfa(const char* src, std::size_t n, char* dst,
+                                      char stop1, char stop2)
+    {
+      utf8_validator v;
+      std::size_t i = 0;
+      for (; i < n; ++i) {
+        const char c = src[i];
+        if (c == stop1 || c == stop2) break;
+        if constexpr (Validate) {
+          v.feed(c);
+          if (v.failed()) return utf8_run{i, false};
+        }
+        dst[i] = c;
+      }
+      return utf8_run{i, v.valid()};
+    }
+
+#if CX_UTF8_SSSE3
+    inline bool has_ssse3()
+    {
+#ifdef __SSSE3__
+      return true;
+#else
+      static const bool has = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") != 0;
+      }();
+      return has;
+#endif
+    }
+
+    // the state carried from one block to the next: the block itself (the
+    // first bytes of a block may continue sequences begun in it), the
+    // sequences that it left incomplete, and the errors so far
+    struct utf8_blocks
+    {
+      __m128i prev = _mm_setzero_si128();
+      __m128i incomplete = _mm_setzero_si128();
+      __m128i error = _mm_setzero_si128();
+    };
+
+    __attribute__((target("ssse3")))
+    inline void check_utf8_block(utf8_blocks& b, __m128i x)
+    {
+      if (_mm_movemask_epi8(x) == 0) {
+        // ASCII: all that can be wrong is a sequence the last block began
+        b.error = _mm_or_si128(b.error, b.incomplete);
+        b.incomplete = _mm_setzero_si128();
+        b.prev = x;
+        return;
+      }
+
+      // each bit is an error that a pair of bytes (the first, then the
+      // second) may show: the pair shows it if both bytes' nibbles do
+      constexpr char too_short = 1 << 0;     // lead, then no continuation
+      constexpr char too_long = 1 << 1;      // ASCII, then continuation
+      constexpr char overlong_3 = 1 << 2;    // E0, then 80-9F
+      constexpr char too_large = 1 << 3;     // F4, then 90-BF (or F5-FF)
+      constexpr char surrogate = 1 << 4;     // ED, then A0-BF
+      constexpr char overlong_2 = 1 << 5;    // C0-C1, then continuation
+      constexpr char too_large_1000 = 1 << 6;  // F5-FF, then 80-8F
+      constexpr char overlong_4 = 1 << 6;    // F0, then 80-8F
+      constexpr char two_conts = static_cast<char>(1 << 7);  // continuation, then continuation
+      constexpr char carry = too_short | too_long | two_conts;
+
+      const __m128i byte_1_high = _mm_setr_epi8(
+          too_long, too_long, too_long, too_long,
+          too_long, too_long, too_long, too_long,
+          two_conts, two_conts, two_conts, two_conts,
+          too_short | overlong_2,
+          too_short,
+          too_short | overlong_3 | surrogate,
+          too_short | too_large | too_large_1000 | overlong_4);
+      const __m128i byte_1_low = _mm_setr_epi8(
+          carry | overlong_3 | overlong_2 | overlong_4,
+          carry | overlong_2,
+          carry,
+          carry,
+          carry | too_large,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000 | surrogate,
+          carry | too_large | too_large_1000,
+          carry | too_large | too_large_1000);
+      const __m128i byte_2_high = _mm_setr_epi8(
+          too_short, too_short, too_short, too_short,
+          too_short, too_short, too_short, too_short,
+          too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+          too_long | overlong_2 | two_conts | overlong_3 | too_large,
+          too_long | overlong_2 | two_conts | surrogate | too_large,
+          too_long | overlong_2 | two_conts | surrogate | too_large,
+          too_short, too_short, too_short, too_short);
+
+      const __m128i nibble = _mm_set1_epi8(0x0f);
+      const __m128i prev1 = _mm_alignr_epi8(x, b.prev, 15);
+      const __m128i special = _mm_and_si128(
+          _mm_and_si128(
+              _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+              _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+          _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(x, 4), nibble)));
+
+      // two continuations in a row are right only where they're the third
+      // or fourth bytes of a sequence (whose lead is 2 or 3 bytes back)
+      const __m128i third = _mm_subs_epu8(_mm_alignr_epi8(x, b.prev, 14),
+                                          _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+      const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(x, b.prev, 13),
+                                           _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+      const __m128i must_be_cont = _mm_and_si128(_mm_or_si128(third, fourth),
+                                                 _mm_set1_epi8(two_conts));
+      b.error = _mm_or_si128(b.error, _mm_xor_si128(must_be_cont, special));
+
+      // a lead byte in the last 3 bytes may begin a sequence that this
+      // block doesn't finish
+      b.incomplete = _mm_subs_epu8(x, _mm_setr_epi8(
+          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+          static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1),
+          static_cast<char>(0xc0 - 1)));
+      b.prev = x;
+    }
+
+    inline bool utf8_blocks_valid(const utf8_blocks& b)
+    {
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(b.error, _mm_setzero_si128())) == 0xffff;
+    }
+
+    // The tail of a run (fewer than 16 chars) is checked as a block padded
+    // with zeros, which are ASCII: so that a sequence the tail leaves
+    // incomplete is an error.
+    __attribute__((target("ssse3")))
+    inline bool check_utf8_tail(utf8_blocks& b, const char* src, std::size_t n)
+    {
+      alignas(16) char tail[16] = {};
+      std::memcpy(tail, src, n);
+      check_utf8_block(b, _mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+      return utf8_blocks_valid(b);
+    }
+
+    __attribute__((target("ssse3")))
+    inline bool is_utf8_ssse3(const char* src, std::size_t n)
+    {
+      utf8_blocks b;
+      std::size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        check_utf8_block(b, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+      }
+      return check_utf8_tail(b, src + i, n - i);
+    }
+
+    inline unsigned stops_in(__m128i x, __m128i stop1, __m128i stop2)
+    {
+      return static_cast<unsigned>(_mm_movemask_epi8(
+          _mm_or_si128(_mm_cmpeq_epi8(x, stop1), _mm_cmpeq_epi8(x, stop2))));
+    }
+
+    // the rest of a run, after its whole blocks
+    inline std::size_t run_tail(const char* src, std::size_t i, std::size_t n,
+                                char stop1, char stop2)
+    {
+      for (; i < n && src[i] != stop1 && src[i] != stop2; ++i);
+      return i;
+    }
+
+    // The size of a run of chars up to a stop char. The whole blocks of the
+    // run are copied (and checked) as they are found; the rest is left to
+    // the caller.
+    __attribute__((target("ssse3")))
+    inline std::size_t copy_utf8_blocks(utf8_blocks& b, const char* src, std::size_t n,
+                                        char* dst, char stop1, char stop2)
+    {
+      const __m128i s1 = _mm_set1_epi8(stop1);
+      const __m128i s2 = _mm_set1_epi8(stop2);
+      std::size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const auto stops = stops_in(x, s1, s2);
+        if (stops != 0) return i + lowest_bit(stops);
+        check_utf8_block(b, x);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), x);
+      }
+      return run_tail(src, i, n, stop1, stop2);
+    }
+
+    inline std::size_t copy_blocks(const char* src, std::size_t n, char* dst,
+                                   char stop1, char stop2)
+    {
+      const __m128i s1 = _mm_set1_epi8(stop1);
+      const __m128i s2 = _mm_set1_epi8(stop2);
+      std::size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const auto stops = stops_in(x, s1, s2);
+        if (stops != 0) return i + lowest_bit(stops);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), x);
+      }
+      return run_tail(src, i, n, stop1, stop2);
+    }
+
+    __attribute__((target("ssse3")))
+    inline utf8_run copy_until_ssse3(const char* src, std::size_t n, char* dst,
+                                     char stop1, char stop2)
+    {
+      utf8_blocks b;
+      const auto size = copy_utf8_blocks(b, src, n, dst, stop1, stop2);
+      const auto blocks = size - size % 16;
+      std::memcpy(dst + blocks, src + blocks, size - blocks);
+      return utf8_run{size, check_utf8_tail(b, src + blocks, size - blocks)};
+    }
+
+    inline utf8_run copy_until_sse2(const char* src, std::size_t n, char* dst,
+                                    char stop1, char stop2)
+    {
+      const auto size = copy_blocks(src, n, dst, stop1, stop2);
+      const auto blocks = size - size % 16;
+      std::memcpy(dst + blocks, src + blocks, size - blocks);
+      return utf8_run{size, true};
+    }
+#endif
+  }
+
+  // whether s is well-formed UTF-8
+  constexpr bool is_utf8(std::string_view s)
+  {
+#if CX_UTF8_SSSE3
+    if (!cx::is_constant_evaluated() && detail::has_ssse3()) {
+      return detail::is_utf8_ssse3(s.data(), s.size());
+    }
+#endif
+    utf8_validator v;
+    for (const auto c : s) {
+      v.feed(c);
+      if (v.failed()) return false;
+    }
+    return v.valid();
+  }
+
+  // Copy chars from src to dst until either stop char (which should be
+  // ASCII) or n chars, whichever is first. With Validate, also check that
+  // they're well-formed UTF-8: since a stop char can't be part of a
+  // multi-byte sequence, the run must be valid on its own. The result is
+  // the number of chars copied, and whether they were valid (once they
+  // aren't, not all of the run may have been copied).
+  template <bool Validate>
+  constexpr utf8_run utf8_copy_until(const char* src, std::size_t n, char* dst,
+                                     char stop1, char stop2)
+  {
+#if CX_UTF8_SSSE3
+    if (!cx::is_constant_evaluated()) {
+      if constexpr (Validate) {
+        if (detail::has_ssse3()) return detail::copy_until_ssse3(src, n, dst, stop1, stop2);
+      } else {
+        return detail::copy_until_sse2(src, n, dst, stop1, stop2);
+      }
+    }
+#endif
+    return detail::copy_until_dfa<Validate>(src, n, dst, stop1, stop2);
+  }
+}
@@ -1,15 +1,24 @@
 #pragma once
 
 #include "cx_algorithm.h"
+#include "cx_config.h"
 #include "cx_iterator.h"
 
 #include <array>
 #include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
 namespace cx
 {
+  // A vector (or basic_string, or map) with this Size has no fixed capacity:
+  // it grows on the heap instead
+  inline constexpr std::size_t dynamic_extent = std::numeric_limits<std::size_t>::max();
+
   template <typename Value, std::size_t Size = 5>
   class vector
   {
@@ -107,11 +116,228 @@ namespace cx
       return m_data.data();
     }
 
+    // As std::basic_string::resize_and_overwrite: op(p, n) may write up to n
+    // elements at p (the first size() of which are the current contents), and
+    // returns the new size.
+    template <typename Operation>
+    constexpr void resize_and_overwrite(const std::size_t n, Operation op) {
+      if (n > Size) {
+        throw std::range_error("Index past end of vector");
+      }
+      const std::size_t r = op(m_data.data(), n);
+      if (r > n) {
+        throw std::range_error("Index past end of vector");
+      }
+      m_size = r;
+    }
+
   private:
     storage_t m_data{};
     std::size_t m_size{0};
   };
 
+  namespace detail
+  {
+    // Constructing and destroying objects in allocated storage can only be
+    // done in constant expressions from C++20.
+    template <typename T, typename... Args>
+    CX_CONSTEXPR20 T* construct_at(T* p, Args&&... args)
+    {
+#if CX_CONSTEXPR_ALLOCATION
+      return std::construct_at(p, std::forward<Args>(args)...);
+#else
+      return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+#endif
+    }
+
+    template <typename T>
+    CX_CONSTEXPR20 void destroy_at(T* p)
+    {
+      p->~T();
+    }
+  }
+
+  // The growable vector keeps its elements in a heap buffer that grows
+  // geometrically. With C++20 it can also be used during constant evaluation
+  // (though, like any allocation there, it can't outlive the evaluation);
+  // before that it is runtime-only. Like the fixed vector, the element past
+  // the end is value-initialized, so a vector of chars is null terminated.
+  template <typename Value>
+  class vector<Value, dynamic_extent>
+  {
+  public:
+    using iterator = Value*;
+    using const_iterator = const Value*;
+    using value_type = Value;
+    using reference = Value&;
+    using const_reference = const Value&;
+
+    template<typename Itr>
+    constexpr vector(Itr begin, const Itr &end)
+    {
+      while (begin != end) {
+        push_back(*begin);
+        ++begin;
+      }
+    }
+    constexpr vector(std::initializer_list<Value> init)
+    {
+      reserve(init.size());
+      for (const auto& v : init) push_back(v);
+    }
+
+    constexpr vector() = default;
+
+    constexpr vector(const vector &other)
+    {
+      reserve(other.size());
+      for (const auto& v : other) push_back(v);
+    }
+    constexpr vector(vector &&other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    constexpr vector &operator=(vector other) noexcept {
+      std::swap(m_data, other.m_data);
+      std::swap(m_size, other.m_size);
+      std::swap(m_capacity, other.m_capacity);
+      return *this;
+    }
+
+    CX_CONSTEXPR20 ~vector() { release(); }
+
+    constexpr const Value* begin() const { return m_data; }
+    constexpr Value* begin() { return m_data; }
+    constexpr const Value* end() const { return m_data + m_size; }
+    constexpr Value* end() { return m_data + m_size; }
+
+    constexpr const Value* cbegin() const { return m_data; }
+    constexpr const Value* cend() const { return m_data + m_size; }
+
+    constexpr const Value &operator[](const std::size_t t_pos) const {
+      return m_data[t_pos];
+    }
+    constexpr Value &operator[](const std::size_t t_pos) {
+      return m_data[t_pos];
+    }
+
+    constexpr Value &at(const std::size_t t_pos) {
+      if (t_pos >= m_size) {
+        throw std::range_error("Index past end of vector");
+      } else {
+        return m_data[t_pos];
+      }
+    }
+    constexpr const Value &at(const std::size_t t_pos) const {
+      if (t_pos >= m_size) {
+        throw std::range_error("Index past end of vector");
+      } else {
+        return m_data[t_pos];
+      }
+    }
+
+    constexpr Value& push_back(Value t_v) {
+      if (m_size == m_capacity) {
+        reserve(m_capacity == 0 ? 8 : m_capacity * 2);
+      }
+      detail::construct_at(m_data + m_size + 1);
+      Value& v = m_data[m_size++];
+      v = std::move(t_v);
+      return v;
+    }
+
+    constexpr const Value &back() const {
+      if (empty()) {
+        throw std::range_error("Index past end of vector");
+      } else {
+        return m_data[m_size - 1];
+      }
+    }
+    constexpr Value &back() {
+      if (empty()) {
+        throw std::range_error("Index past end of vector");
+      } else {
+        return m_data[m_size - 1];
+      }
+    }
+
+    // make room for at least n elements
+    constexpr void reserve(std::size_t n) {
+      if (n <= m_capacity) return;
+      // one extra for the element past the end
+      Value* data = std::allocator<Value>{}.allocate(n + 1);
+      for (std::size_t i = 0; i < m_size; ++i) {
+        detail::construct_at(data + i, std::move(m_data[i]));
+      }
+      detail::construct_at(data + m_size);
+      release();
+      m_data = data;
+      m_capacity = n;
+    }
+
+    constexpr std::size_t capacity() const { return m_capacity; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+
+    constexpr void clear() {
+      if (m_data == nullptr) return;
+      for (std::size_t i = 1; i <= m_size; ++i) {
+        detail::destroy_at(m_data + i);
+      }
+      m_size = 0;
+      m_data[0] = Value{};
+    }
+
+    constexpr const Value* data() const {
+      return m_data;
+    }
+
+    // As for the fixed vector, but n may be anything: the vector grows to
+    // hold it. The elements past the current size are value-initialized
+    // before op sees them.
+    template <typename Operation>
+    constexpr void resize_and_overwrite(const std::size_t n, Operation op) {
+      if (n > m_capacity || m_data == nullptr) {
+        // grow geometrically, as push_back does
+        const std::size_t twice = m_capacity == 0 ? 8 : m_capacity * 2;
+        reserve(n > twice ? n : twice);
+      }
+      for (std::size_t i = m_size + 1; i <= n; ++i) {
+        detail::construct_at(m_data + i);
+      }
+      const std::size_t constructed = n > m_size ? n : m_size;
+      const std::size_t r = op(m_data, n);
+      if (r > n) {
+        throw std::range_error("Index past end of vector");
+      }
+      // keep the element past the end value-initialized
+      for (std::size_t i = r + 1; i <= constructed; ++i) {
+        detail::destroy_at(m_data + i);
+      }
+      m_data[r] = Value{};
+      m_size = r;
+    }
+
+  private:
+    // destroy the elements (and the one past the end) and free the buffer,
+    // leaving the size and capacity for the caller to reset
+    constexpr void release() {
+      if (m_data == nullptr) return;
+      for (std::size_t i = 0; i <= m_size; ++i) {
+        detail::destroy_at(m_data + i);
+      }
+      std::allocator<Value>{}.deallocate(m_data, m_capacity + 1);
+      m_data = nullptr;
+    }
+
+    Value* m_data = nullptr;
+    std::size_t m_size{0};
+    std::size_t m_capacity{0};
+  };
+
   template<typename T, size_t Size1, size_t Size2>
   constexpr bool operator==(const vector<T, Size1> &x, const vector<T, Size2> &y)
   {
@@ -120,11 +346,14 @@ namespace cx
 
 
   // Is addition (concatenation) on strings useful? Not sure yet. But it does
-  // allow us to carry the type information properly.
+  // allow us to carry the type information properly. (If either side can
+  // grow, so can the result.)
 
   template <typename Value, std::size_t S1, std::size_t S2>
   constexpr auto operator+(vector<Value, S1> a, vector<Value, S2> b) {
-    vector<Value, S1+S2> v;
+    constexpr auto S = S1 == dynamic_extent || S2 == dynamic_extent
+      ? dynamic_extent : S1+S2;
+    vector<Value, S> v;
     copy(a.cbegin(), a.cend(), back_insert_iterator(v));
     copy(b.cbegin(), b.cend(), back_insert_iterator(v));
     return v;
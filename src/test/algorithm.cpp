@@ -1,7 +1,19 @@
 #include <cx_algorithm.h>
+#include <cx_execution.h>
 #include <cx_vector.h>
+#include <cx_pair.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 
 void algo_tests_nonmod()
 {
@@ -91,6 +103,37 @@ void algo_tests_nonmod()
     static_assert(it == haystack.cbegin() + 1, "search fail");
   }
 
+  {
+    using namespace std::literals;
+    constexpr std::string_view haystack = "the quick brown fox jumps over the lazy dog"sv;
+    constexpr std::string_view subseq = "the"sv;
+    constexpr auto bmh = cx::boyer_moore_horspool_searcher(subseq.cbegin(), subseq.cend());
+    constexpr auto two_way = cx::two_way_searcher(subseq.cbegin(), subseq.cend());
+    static_assert(cx::search(haystack.cbegin(), haystack.cend(), bmh) == haystack.cbegin()
+                  && cx::search(haystack.cbegin(), haystack.cend(), two_way) == haystack.cbegin(),
+                  "searcher fail");
+    static_assert(cx::find_end(haystack.cbegin(), haystack.cend(), bmh) == haystack.cbegin() + 31
+                  && cx::find_end(haystack.cbegin(), haystack.cend(), two_way) == haystack.cbegin() + 31,
+                  "searcher fail");
+
+    constexpr std::string_view missing = "cat"sv;
+    static_assert(cx::search(haystack.cbegin(), haystack.cend(),
+                             cx::boyer_moore_horspool_searcher(missing.cbegin(), missing.cend()))
+                  == haystack.cend(), "searcher fail");
+  }
+
+  {
+    // a periodic pattern, which the naive search would crawl through
+    constexpr auto found = [] () {
+        cx::vector<char, 4096> v;
+        for (int i = 0; i < 4000; ++i) v.push_back('a');
+        v.push_back('b');
+        constexpr std::string_view subseq = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab";
+        return cx::search(v.cbegin(), v.cend(), subseq.cbegin(), subseq.cend()) - v.cbegin();
+    }();
+    static_assert(found == 4000 - 31, "search fail");
+  }
+
   {
     using namespace std::literals;
 
@@ -218,3 +261,370 @@ void algo_tests_mod()
   }
 
 }
+
+void algo_tests_sorting()
+{
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 40> v;
+        // enough elements to partition, not just insertion sort
+        for (int i = 0; i < 40; ++i) v.push_back((i * 17) % 40 - 20);
+        cx::sort(v.begin(), v.end());
+        return v;
+    }();
+    static_assert(cx::is_sorted(vec.cbegin(), vec.cend())
+                  && vec[0] == -20 && vec[39] == 19, "sort fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 5> v{3, 1, 5, 2, 4};
+        cx::sort(v.begin(), v.end(), [] (int a, int b) { return a > b; });
+        return v;
+    }();
+    static_assert(cx::is_sorted(vec.cbegin(), vec.cend(),
+                                [] (int a, int b) { return a > b; })
+                  && vec[0] == 5, "sort fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 10> v{9, 3, 7, 1, 8, 0, 6, 2, 5, 4};
+        cx::partial_sort(v.begin(), v.begin() + 3, v.end());
+        return v;
+    }();
+    static_assert(vec[0] == 0 && vec[1] == 1 && vec[2] == 2, "partial_sort fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 30> v;
+        for (int i = 0; i < 30; ++i) v.push_back((i * 7) % 30);
+        cx::nth_element(v.begin(), v.begin() + 12, v.end());
+        return v;
+    }();
+    static_assert(vec[12] == 12
+                  && cx::all_of(vec.cbegin(), vec.cbegin() + 12,
+                                [] (int i) { return i < 12; }), "nth_element fail");
+  }
+
+  {
+    // stable: equal keys keep their order
+    using P = cx::pair<int, char>;
+    constexpr auto vec = [] () {
+        cx::vector<P, 40> v;
+        for (int i = 0; i < 40; ++i) v.push_back(P{i % 3, static_cast<char>('0' + i)});
+        cx::stable_sort(v.begin(), v.end(),
+                        [] (const P& a, const P& b) { return a.first < b.first; });
+        return v;
+    }();
+    static_assert(vec[0].second == '0' && vec[1].second == '3'
+                  && vec[13].first == 0 && vec[14].second == '1'
+                  && vec[39].second == 'V', "stable_sort fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 8> v{1, 4, 6, 7, 2, 3, 5, 8};
+        cx::inplace_merge(v.begin(), v.begin() + 4, v.end());
+        return v;
+    }();
+    static_assert(cx::is_sorted(vec.cbegin(), vec.cend()), "inplace_merge fail");
+  }
+
+  {
+    constexpr auto arr = [] () {
+        std::array<int, 8> a{300, -1, 70000, 0, -70000, 2, -1, 5};
+        std::array<int, 8> scratch{};
+        cx::radix_sort(a.begin(), a.end(), scratch.begin(),
+                       [] (int i) { return i; });
+        return a;
+    }();
+    static_assert(cx::is_sorted(arr.cbegin(), arr.cend())
+                  && arr[0] == -70000 && arr[7] == 70000, "radix_sort fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<unsigned, 6> v{5u, 0xffffffffu, 3u, 0u, 256u, 1u};
+        cx::radix_sort(v.begin(), v.end());
+        return v;
+    }();
+    static_assert(cx::is_sorted(vec.cbegin(), vec.cend()), "radix_sort fail");
+  }
+}
+
+void algo_tests_binary_search()
+{
+  static constexpr int arr[] = {1, 2, 2, 2, 5, 8, 13};
+
+  {
+    constexpr auto lb = cx::lower_bound(std::cbegin(arr), std::cend(arr), 2);
+    constexpr auto ub = cx::upper_bound(std::cbegin(arr), std::cend(arr), 2);
+    static_assert(lb == std::cbegin(arr) + 1 && ub == std::cbegin(arr) + 4,
+                  "lower_bound/upper_bound fail");
+    static_assert(cx::lower_bound(std::cbegin(arr), std::cend(arr), 14) == std::cend(arr),
+                  "lower_bound fail");
+  }
+
+  {
+    constexpr auto r = cx::equal_range(std::cbegin(arr), std::cend(arr), 2);
+    static_assert(r.second - r.first == 3, "equal_range fail");
+    static_assert(cx::binary_search(std::cbegin(arr), std::cend(arr), 8)
+                  && !cx::binary_search(std::cbegin(arr), std::cend(arr), 7),
+                  "binary_search fail");
+  }
+
+  {
+    // the branchless versions agree with the others for every value
+    constexpr bool ok = [] () {
+        for (int i = 0; i <= 14; ++i) {
+          if (cx::branchless_lower_bound(std::cbegin(arr), std::cend(arr), i)
+              != cx::lower_bound(std::cbegin(arr), std::cend(arr), i)
+              || cx::branchless_upper_bound(std::cbegin(arr), std::cend(arr), i)
+              != cx::upper_bound(std::cbegin(arr), std::cend(arr), i)) {
+            return false;
+          }
+        }
+        return true;
+    }();
+    static_assert(ok, "branchless bound fail");
+  }
+}
+
+void algo_tests_numeric()
+{
+  static constexpr int arr[] = {1, 2, 3, 4, 5};
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 5> v;
+        cx::transform(std::cbegin(arr), std::cend(arr), cx::back_insert_iterator(v),
+                      [] (int i) { return i * i; });
+        return v;
+    }();
+    static_assert(vec.size() == 5 && vec[4] == 25, "transform fail");
+  }
+
+  {
+    constexpr auto vec = [] () {
+        cx::vector<int, 5> v;
+        cx::transform(std::cbegin(arr), std::cend(arr), std::cbegin(arr),
+                      cx::back_insert_iterator(v), std::plus<>{});
+        return v;
+    }();
+    static_assert(vec.size() == 5 && vec[2] == 6, "transform (binary) fail");
+  }
+
+  static_assert(cx::accumulate(std::cbegin(arr), std::cend(arr), 0) == 15,
+                "accumulate fail");
+  static_assert(cx::reduce(std::cbegin(arr), std::cend(arr)) == 15, "reduce fail");
+  static_assert(cx::reduce(std::cbegin(arr), std::cend(arr), 1, std::multiplies<>{}) == 120,
+                "reduce fail");
+}
+
+void algo_tests_execution()
+{
+  // in constant evaluation the policy overloads run sequentially
+  static constexpr int arr[] = {3, 1, 4, 1, 5, 9, 2, 6};
+
+  static_assert(cx::find(cx::execution::par, std::cbegin(arr), std::cend(arr), 5)
+                == std::cbegin(arr) + 4, "find (par) fail");
+  static_assert(cx::count(cx::execution::par, std::cbegin(arr), std::cend(arr), 1) == 2,
+                "count (par) fail");
+  static_assert(cx::all_of(cx::execution::seq, std::cbegin(arr), std::cend(arr),
+                           [] (int i) { return i > 0; })
+                && cx::none_of(cx::execution::par, std::cbegin(arr), std::cend(arr),
+                               [] (int i) { return i > 9; }),
+                "all_of/none_of (par) fail");
+  static_assert(cx::reduce(cx::execution::par, std::cbegin(arr), std::cend(arr), 0) == 31,
+                "reduce (par) fail");
+
+  {
+    constexpr auto a = [] () {
+        std::array<int, 8> r{};
+        cx::transform(cx::execution::par, std::cbegin(arr), std::cend(arr), r.begin(),
+                      [] (int i) { return 2 * i; });
+        cx::sort(cx::execution::par, r.begin(), r.end());
+        return r;
+    }();
+    static_assert(a[0] == 2 && a[7] == 18 && cx::is_sorted(a.cbegin(), a.cend()),
+                  "transform/sort (par) fail");
+  }
+
+  {
+    constexpr auto a = [] () {
+        std::array<int, 8> r{};
+        cx::fill(cx::execution::par, r.begin(), r.end(), 7);
+        std::array<int, 8> s{};
+        cx::copy(cx::execution::par, r.cbegin(), r.cend(), s.begin());
+        return s;
+    }();
+    static_assert(a[0] == 7 && a[7] == 7, "fill/copy (par) fail");
+  }
+}
+
+// The runtime (SSE2/AVX2) paths of find, mismatch and equal, against std::,
+// over every length up to past two AVX2 blocks and every alignment.
+bool algo_runtime_tests_simd()
+{
+  bool ok = true;
+  const auto check = [&ok] (bool b, const char* what, std::size_t off, std::size_t n) {
+    if (!b) {
+      std::cerr << what << " fail (offset " << off << ", length " << n << ")\n";
+      ok = false;
+    }
+  };
+
+  std::array<unsigned char, 160> a{};
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<unsigned char>(i * 7 % 251 + 1);
+  }
+  std::array<int, 100> ai{};
+  for (std::size_t i = 0; i < ai.size(); ++i) ai[i] = static_cast<int>(i) - 50;
+
+  for (std::size_t off = 0; off < 32; ++off) {
+    for (std::size_t n = 0; n <= 72; ++n) {
+      const auto first = a.data() + off;
+      const auto last = first + n;
+
+      // find each byte present, and one that isn't
+      for (std::size_t i = 0; i < n; ++i) {
+        check(cx::find(first, last, first[i]) == std::find(first, last, first[i]),
+              "find", off, n);
+      }
+      check(cx::find(first, last, static_cast<unsigned char>(0)) == last, "find", off, n);
+
+      // a copy that differs at each position in turn
+      std::array<unsigned char, 160> b = a;
+      const auto bfirst = b.data() + off;
+      check(cx::equal(first, last, bfirst, bfirst + n), "equal", off, n);
+      check(n == 0 || !cx::equal(first, last, bfirst, bfirst + n - 1), "equal", off, n);
+      for (std::size_t i = 0; i < n; ++i) {
+        bfirst[i] ^= 0x80;
+        const auto r = cx::mismatch(first, last, bfirst, bfirst + n);
+        const auto e = std::mismatch(first, last, bfirst, bfirst + n);
+        check(r.first == e.first && r.second == e.second, "mismatch", off, n);
+        check(!cx::equal(first, last, bfirst, bfirst + n), "equal", off, n);
+        bfirst[i] ^= 0x80;
+      }
+
+      // wider elements, and (with C++20) non-pointer contiguous iterators
+      if (off < 16 && n + off <= ai.size()) {
+        std::vector<int> bi(ai.begin(), ai.end());
+        const auto ifirst = ai.cbegin() + static_cast<std::ptrdiff_t>(off);
+        const auto bifirst = bi.cbegin() + static_cast<std::ptrdiff_t>(off);
+        check(cx::equal(ifirst, ifirst + static_cast<std::ptrdiff_t>(n),
+                        bifirst, bifirst + static_cast<std::ptrdiff_t>(n)), "equal", off, n);
+        if (n != 0) {
+          bi[off + n - 1] += 1;
+          const auto r = cx::mismatch(ifirst, ifirst + static_cast<std::ptrdiff_t>(n),
+                                      bifirst, bifirst + static_cast<std::ptrdiff_t>(n));
+          check(r.first == ifirst + static_cast<std::ptrdiff_t>(n - 1)
+                && r.second == bifirst + static_cast<std::ptrdiff_t>(n - 1),
+                "mismatch", off, n);
+        }
+      }
+    }
+  }
+  return ok;
+}
+
+// The parallel algorithms at runtime, against the sequential ones, over a
+// range large enough to be split. Where the machine has a single core the
+// policy overloads run sequentially, so the chunked implementations are
+// also called directly (the calling thread then runs every chunk), and the
+// pool is tested with threads of its own.
+bool algo_runtime_tests_execution()
+{
+  bool ok = true;
+  const auto check = [&ok] (bool b, const char* what) {
+    if (!b) {
+      std::cerr << what << " fail\n";
+      ok = false;
+    }
+  };
+
+  {
+    cx::detail::work_stealing_pool pool(3);
+    std::atomic<std::size_t> sum{0};
+    pool.parallel_for(1000, [&] (std::size_t i) { sum += i; });
+    check(sum == 499500, "parallel_for");
+
+    // a task may itself wait for a batch
+    sum = 0;
+    pool.parallel_for(8, [&] (std::size_t) {
+        pool.parallel_for(100, [&] (std::size_t i) { sum += i; });
+    });
+    check(sum == 8 * 4950, "nested parallel_for");
+
+    bool thrown = false;
+    try {
+      pool.parallel_for(16, [] (std::size_t i) {
+          if (i == 5) throw std::runtime_error("task failed");
+      });
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    check(thrown, "parallel_for exception");
+  }
+
+  constexpr std::size_t n = std::size_t{1} << 18;
+  std::vector<int> v(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    v[i] = static_cast<int>((i * 2654435761u) % 1000003u);
+  }
+  const auto first = v.cbegin();
+  const auto last = v.cend();
+  const auto is_big = [] (int i) { return i > 1000000; };
+
+  check(cx::find_if(cx::execution::par, first, last, is_big) == std::find_if(first, last, is_big),
+        "find_if (par)");
+  check(cx::find(cx::execution::par, first, last, v[n - 3]) == std::find(first, last, v[n - 3]),
+        "find (par)");
+  check(cx::find(cx::execution::par, first, last, -1) == last, "find (par)");
+  check(cx::count_if(cx::execution::par, first, last, is_big)
+        == std::count_if(first, last, is_big), "count_if (par)");
+  check(cx::reduce(cx::execution::par, first, last, std::int64_t{0})
+        == std::accumulate(first, last, std::int64_t{0}), "reduce (par)");
+
+  {
+    std::vector<int> t(n);
+    cx::transform(cx::execution::par, first, last, t.begin(), [] (int i) { return i / 2; });
+    std::vector<int> e(n);
+    std::transform(first, last, e.begin(), [] (int i) { return i / 2; });
+    check(t == e, "transform (par)");
+
+    cx::fill(cx::execution::par, t.begin(), t.end(), 7);
+    check(std::count(t.cbegin(), t.cend(), 7) == static_cast<std::ptrdiff_t>(n), "fill (par)");
+    cx::copy(cx::execution::par, first, last, t.begin());
+    check(t == v, "copy (par)");
+  }
+
+  std::vector<int> sorted = v;
+  std::sort(sorted.begin(), sorted.end());
+  {
+    std::vector<int> s = v;
+    cx::sort(cx::execution::par, s.begin(), s.end());
+    check(s == sorted, "sort (par)");
+  }
+
+  // the chunked implementations, whatever the number of cores
+  {
+    std::vector<int> s = v;
+    auto comp = std::less<>{};
+    cx::detail::parallel_sort(s.begin(), s.end(), comp);
+    check(s == sorted, "parallel_sort");
+
+    auto plus = std::plus<>{};
+    check(cx::detail::parallel_reduce(first, last, std::int64_t{0}, plus)
+          == std::accumulate(first, last, std::int64_t{0}), "parallel_reduce");
+
+    auto p = [&] (int i) { return i == v[n / 2 + 1]; };
+    check(cx::detail::parallel_find_if(first, last, p) == std::find_if(first, last, p),
+          "parallel_find_if");
+    check(cx::detail::parallel_count_if(first, last, is_big)
+          == std::count_if(first, last, is_big), "parallel_count_if");
+  }
+  return ok;
+}
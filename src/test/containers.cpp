@@ -0,0 +1,178 @@
+#include <cx_eytzinger.h>
+#include <cx_flat_map.h>
+#include <cx_map.h>
+#include <cx_parser.h>
+#include <cx_static_unordered_map.h>
+#include <cx_string.h>
+#include <cx_vector.h>
+
+#include <string_view>
+
+using namespace std::literals;
+
+void map_tests()
+{
+  {
+    constexpr auto map = [] () {
+        cx::map<int, int> m;
+        m[1] = 10;
+        m[2] = 20;
+        m[1] = 11;
+        return m;
+    }();
+    static_assert(map.size() == 2 && map.at(1) == 11 && map.at(2) == 20, "map fail");
+    static_assert(map.find(3) == map.end(), "map fail");
+  }
+}
+
+void flat_map_tests()
+{
+  {
+    // entries are kept sorted, whatever order they arrive in
+    static constexpr cx::flat_map<int, char, 8> m = {
+      {5, 'e'}, {1, 'a'}, {4, 'd'}, {2, 'b'}, {3, 'c'}, {1, 'z'}
+    };
+    static_assert(m.size() == 5, "flat_map fail");
+    static_assert(m.begin()->first == 1 && (m.end() - 1)->first == 5, "flat_map fail");
+    static_assert(m.at(1) == 'a' && m.at(4) == 'd', "flat_map fail");
+    static_assert(m.find(6) == m.end(), "flat_map fail");
+
+    // range queries
+    constexpr auto r = m.range(2, 4);
+    static_assert(r.second - r.first == 2 && r.first->second == 'b', "flat_map fail");
+    static_assert(m.upper_bound(5) == m.end() && m.lower_bound(0) == m.begin(),
+                  "flat_map fail");
+  }
+
+  {
+    constexpr auto m = [] () {
+        cx::flat_map<int, int> fm;
+        fm[3] = 30;
+        fm[1] = 10;
+        fm[2] = 20;
+        fm[1] = 11;
+        return fm;
+    }();
+    static_assert(m.size() == 3 && m.at(1) == 11 && m.at(3) == 30, "flat_map fail");
+  }
+
+  {
+    // a transparent comparator allows lookup by other kinds of string
+    constexpr cx::flat_map<std::string_view, int, 3, std::less<>> m = {
+      {"two"sv, 2}, {"one"sv, 1}, {"three"sv, 3}
+    };
+    static_assert(m.at("three"sv) == 3, "flat_map fail");
+    static_assert(m.begin()->first == "one"sv, "flat_map fail");
+  }
+}
+
+void growable_vector_tests()
+{
+#if CX_CONSTEXPR_ALLOCATION
+  {
+    // a growable vector has no capacity limit...
+    constexpr auto sum = [] () {
+        cx::vector<int, cx::dynamic_extent> v;
+        for (int i = 1; i <= 100; ++i) v.push_back(i);
+        auto w = v;
+        int n = 0;
+        for (auto i : w) n += i;
+        return v.size() == 100 && v.capacity() >= 100 ? n : -1;
+    }();
+    static_assert(sum == 5050, "growable vector fail");
+  }
+
+  {
+    // ...and neither do the things built on it
+    constexpr auto n = [] () {
+        cx::map<int, int, cx::dynamic_extent> m;
+        for (int i = 0; i < 50; ++i) m[i] = i * 2;
+        return m.at(49);
+    }();
+    static_assert(n == 98, "growable map fail");
+
+    static_assert((cx::string_builder("hello, "sv) + cx::string_builder("world"sv))
+                  == cx::string_builder("hello, world"sv), "growable string fail");
+  }
+
+  {
+    // including parser accumulators
+    using namespace cx::parser;
+    constexpr auto n = [] () {
+        using V = cx::vector<char, cx::dynamic_extent>;
+        const auto p = many(one_of("ab"sv), V{},
+                            [] (V& v, char c) { v.push_back(c); });
+        return p("abababababababababababababababababab!"sv)->first.size();
+    }();
+    static_assert(n == 36, "growable accumulator fail");
+  }
+#endif
+}
+
+void static_unordered_map_tests()
+{
+  {
+    static constexpr auto m = cx::make_static_unordered_map<std::string_view, int>({
+      {"null"sv, 0}, {"true"sv, 1}, {"false"sv, 2}, {"number"sv, 3},
+      {"string"sv, 4}, {"array"sv, 5}, {"object"sv, 6}
+    });
+    static_assert(m.size() == 7, "static_unordered_map fail");
+    static_assert(m.at("null"sv) == 0 && m.at("object"sv) == 6, "static_unordered_map fail");
+    static_assert(m.at("false") == 2 && m.contains("string"), "static_unordered_map fail");
+    static_assert(!m.contains("nul") && !m.contains(""sv), "static_unordered_map fail");
+    static_assert(m.find("arrays"sv) == m.end(), "static_unordered_map fail");
+  }
+
+  {
+    // every key gets its own slot
+    constexpr auto ok = [] () {
+        constexpr auto um = cx::make_static_unordered_map<int, int>({
+          {1, 1}, {2, 4}, {3, 9}, {4, 16}, {5, 25}, {6, 36}, {7, 49}, {8, 64},
+          {9, 81}, {10, 100}, {11, 121}, {12, 144}, {13, 169}, {14, 196}
+        });
+        for (int i = 1; i <= 14; ++i) {
+          if (um.at(i) != i * i) return false;
+        }
+        int sum = 0;
+        for (const auto& e : um) sum += e.first;
+        return sum == 105 && !um.contains(0) && !um.contains(15);
+    }();
+    static_assert(ok, "static_unordered_map fail");
+  }
+
+  {
+    // integer keys can be looked up with integers of other types
+    static constexpr auto m = cx::make_static_unordered_map<long, int>({
+      {1L, 1}, {2L, 2}, {3L, 3}, {40L, 40}, {-7L, -7}
+    });
+    static_assert(m.at(1) == 1 && m.at(2) == 2 && m.at(3) == 3
+                  && m.at(40) == 40 && m.at(-7) == -7, "static_unordered_map fail");
+    static_assert(m.at(40L) == 40 && !m.contains(4), "static_unordered_map fail");
+
+    static constexpr auto c = cx::make_static_unordered_map<unsigned char, int>({
+      {static_cast<unsigned char>(1), 1}, {static_cast<unsigned char>(200), 200},
+      {static_cast<unsigned char>(7), 7}
+    });
+    static_assert(c.contains(1) && c.at(200) == 200 && c.at(7u) == 7,
+                  "static_unordered_map fail");
+  }
+}
+
+void eytzinger_tests()
+{
+  {
+    static constexpr auto e = cx::make_eytzinger({13, 2, 8, 1, 21, 5, 3, 34, 55, 0});
+    // the root is the median
+    static_assert(e.size() == 10 && *e.begin() == 13, "eytzinger fail");
+    static_assert(*e.lower_bound(4) == 5 && *e.lower_bound(5) == 5, "eytzinger fail");
+    static_assert(*e.upper_bound(5) == 8 && e.upper_bound(55) == e.end(), "eytzinger fail");
+    static_assert(*e.lower_bound(-1) == 0 && e.lower_bound(56) == e.end(), "eytzinger fail");
+    static_assert(e.contains(34) && !e.contains(4), "eytzinger fail");
+  }
+
+  {
+    static constexpr cx::eytzinger<std::string_view, 4> e({"b"sv, "d"sv, "a"sv, "c"sv});
+    static_assert(*e.lower_bound("bb"sv) == "c"sv && e.find("e"sv) == e.end(),
+                  "eytzinger fail");
+  }
+}
@@ -0,0 +1,22 @@
+#include <embed_test_json.h>
+
+#include <limits>
+
+void embed_tests()
+{
+  // embed_test.json is compiled into embed_test_json.h by cx_embed_json()
+  using embed_test::json;
+
+  static_assert(json.object_Size() == 7);
+  static_assert(json["name"].to_String() == "embedded \"config\"");
+  static_assert(json["enabled"].to_Boolean());
+  static_assert(json["ratio"].to_Number() == 0.25);
+  static_assert(json["limits"].array_Size() == 3);
+  static_assert(json["limits"][2].to_Number() == 300);
+  static_assert(json["huge"][0].to_Number() == std::numeric_limits<double>::infinity());
+  static_assert(json["huge"][1].to_Number() == -std::numeric_limits<double>::infinity());
+  static_assert(json["id"].to_Int64() == 9007199254740993);
+  static_assert(json["nested"]["empty"].string_Size() == 0);
+  static_assert(json["nested"]["none"].is_Null());
+  static_assert(json["nested"]["path"].to_String() == "a\\b\n\xc3\xa9");
+}
@@ -1,9 +1,18 @@
 #include <cx_algorithm.h>
 
+#include <cx_json_cbor.h>
+#include <cx_json_document.h>
+#include <cx_json_image.h>
 #include <cx_json_parser.h>
+#include <cx_json_schema.h>
 #include <cx_json_value.h>
 
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <tuple>
 
@@ -46,6 +55,22 @@ void string_parse_tests()
                             expected_str.cbegin(), expected_str.cend()));
   }
 
+  {
+    // longer strings need a larger string to accumulate into...
+    constexpr auto str_val = JSON::string_parser<cx::basic_string<char, 64>>()(
+        R"("01234567890123456789012345678901234567890123456789")"sv);
+    static_assert(str_val && str_val->first.size() == 50);
+  }
+
+#if CX_CONSTEXPR_ALLOCATION
+  {
+    // ...or one that grows
+    static_assert(JSON::string_parser<cx::string_builder>()(
+        R"("01234567890123456789012345678901234567890123456789")"sv)
+                  ->first == "01234567890123456789012345678901234567890123456789");
+  }
+#endif
+
   // unicode points: should come out as utf-8
   // U+2603 is the snowman
   {
@@ -55,6 +80,30 @@ void string_parse_tests()
                   && u->first[1] == static_cast<char>(0x98)
                   && u->first[2] == static_cast<char>(0x83));
   }
+
+  // a surrogate pair is one code point: U+1F600 (in any case of hex)
+  {
+    constexpr auto u = JSON::unicode_point_parser()("\\uD83D\\ude00"sv);
+    static_assert(u && u->second.empty() && u->first.size() == 4
+                  && u->first[0] == static_cast<char>(0xf0)
+                  && u->first[1] == static_cast<char>(0x9f)
+                  && u->first[2] == static_cast<char>(0x98)
+                  && u->first[3] == static_cast<char>(0x80));
+    static_assert(JSON::sizes(R"("\ud83d\ude00")"sv).string_size == 4);
+  }
+
+  // a lone surrogate is U+FFFD, leaving what follows it
+  {
+    constexpr auto u = JSON::unicode_point_parser()("\\udc00\\u0041"sv);
+    static_assert(u && u->second == "\\u0041"sv && u->first.size() == 3
+                  && u->first[0] == static_cast<char>(0xef)
+                  && u->first[1] == static_cast<char>(0xbf)
+                  && u->first[2] == static_cast<char>(0xbd));
+    static_assert(JSON::sizes(R"("\ud83dx\ud83d")"sv).string_size == 7);
+  }
+
+  static_assert(!JSON::unicode_point_parser()("\\u26g3"sv));
+  static_assert(!JSON::unicode_point_parser()("\\u260"sv));
 }
 
 void number_parse_tests()
@@ -99,6 +148,99 @@ void number_parse_tests()
     constexpr auto number_val = JSON::number_parser()("456.123e-1"sv);
     static_assert(number_val && number_val->first == 456.123e-1);
   }
+
+  {
+    constexpr auto number_val = JSON::number_parser()("-0.5"sv);
+    static_assert(number_val && number_val->first == -0.5);
+  }
+
+  {
+    constexpr auto number_val = JSON::number_parser()("0.0625"sv);
+    static_assert(number_val && number_val->first == 0.0625);
+  }
+
+  {
+    // long numbers lose precision, but don't overflow
+    constexpr auto number_val = JSON::number_parser()("123456789012345678901234567890"sv);
+    static_assert(number_val && number_val->first > 1.23e29 && number_val->first < 1.24e29);
+  }
+}
+
+void integer_parse_tests()
+{
+  // integers are kept exactly, in 64 bits
+  {
+    constexpr auto i = JSON::integer_parser()("9007199254740993"sv);
+    static_assert(i && i->first.type == JSON::value::Type::Integer
+                  && i->first.to_Int64() == 9007199254740993);
+  }
+  {
+    constexpr auto i = JSON::integer_parser()("-9223372036854775808"sv);
+    static_assert(i && i->first.to_Int64() == std::numeric_limits<std::int64_t>::min());
+  }
+  {
+    constexpr auto i = JSON::integer_parser()("18446744073709551615"sv);
+    static_assert(i && i->first.type == JSON::value::Type::Unsigned
+                  && i->first.to_UInt64() == std::numeric_limits<std::uint64_t>::max());
+  }
+  // ...or they aren't integers
+  static_assert(!JSON::integer_parser()("18446744073709551616"sv));
+  static_assert(!JSON::integer_parser()("-9223372036854775809"sv));
+  static_assert(!JSON::integer_parser()("1.0"sv));
+  static_assert(!JSON::integer_parser()("1e3"sv));
+
+  {
+    // in which case they are doubles
+    constexpr auto n = JSON::number_value_parser()("18446744073709551616"sv);
+    static_assert(n && n->first.type == JSON::value::Type::Number
+                  && n->first.to_Number() == 18446744073709551616.0);
+  }
+
+  using namespace JSON::literals;
+  {
+    constexpr auto jsv = R"({"id": 9223372036854775807, "n": -3, "big": 18446744073709551615})"_json;
+    static_assert(jsv["id"].to_Int64() == 9223372036854775807);
+    static_assert(jsv["n"].to_Int64() == -3 && jsv["n"].to_Number() == -3.0);
+    static_assert(jsv["big"].to_UInt64() == 18446744073709551615u);
+  }
+  {
+    // numbers convert between kinds on request
+    constexpr bool ok = [] {
+      JSON::value v;
+      v.to_Number() = 4;
+      const bool converted = v.to_Int64() == 4 && v.type == JSON::value::Type::Integer;
+      v.to_Int64() = -2;
+      return converted && v.to_Number() == -2.0 && v.type == JSON::value::Type::Number;
+    }();
+    static_assert(ok);
+  }
+  {
+    // assigning through an accessor doesn't depend on the old value
+    constexpr bool ok = [] {
+      JSON::value v;
+      v.to_Number() = 1.5;
+      v.to_Int64() = 3;
+      const bool from_double = v.to_Int64() == 3;
+      v.to_Int64() = -1;
+      v.to_UInt64() = 7;
+      const bool from_negative = v.to_UInt64() == 7 && v.as_Int64() == 7;
+      v.to_UInt64() = 18446744073709551615u;
+      v.to_Int64() = -5;
+      const bool from_big = v.to_Int64() == -5;
+      v.to_Number() = 2.0;
+      return from_double && from_negative && from_big && v.to_UInt64() == 2;
+    }();
+    static_assert(ok);
+
+    // an inexact conversion resets the value (a const access would throw)
+    constexpr bool reset = [] {
+      JSON::value v;
+      v.to_Number() = 1.5;
+      const auto i = v.to_Int64();
+      return i == 0 && v.type == JSON::value::Type::Integer;
+    }();
+    static_assert(reset);
+  }
 }
 
 void numobjects_tests()
@@ -336,6 +478,492 @@ void object_value_tests()
   }
 }
 
+void raw_number_tests()
+{
+  // numbers can be left as their text, and decoded on access
+  constexpr bool ok = [] {
+    constexpr auto text = R"({"a": 1.50, "b": [-0, 18446744073709551615, 2e3]})"sv;
+    static_assert(JSON::sizes(text).num_objects == 8);
+    JSON::value_wrapper<8, 2> jsv;
+    jsv.construct<JSON::raw_number_recur>(text);
+    const auto& cjsv = jsv;
+    const bool raw = cjsv["a"].to_RawNumber() == "1.50"sv
+      && cjsv["b"][0].to_RawNumber() == "-0"sv
+      && cjsv["a"].to_Number() == 1.5
+      && cjsv["b"][1].to_UInt64() == 18446744073709551615u
+      && cjsv["b"][2].to_Number() == 2000;
+    return raw && jsv.objects()[2].type == JSON::value::Type::RawNumber;
+  }();
+  static_assert(ok, "raw numbers decode on access");
+
+  constexpr bool cached = [] {
+    // a non-const access decodes in place, so that it's only done once
+    JSON::value v;
+    v.to_RawNumber() = "2e3"sv;
+    v.to_Number() += 1;
+    return v.type == JSON::value::Type::Number && v.to_Number() == 2001;
+  }();
+  static_assert(cached, "raw numbers decode in place");
+
+  // the extent parser finds numbers without decoding them
+  constexpr auto e = JSON::number_extent_parser()("-12.5e+3,"sv);
+  static_assert(e && e->first == "-12.5e+3"sv && e->second == ","sv);
+  static_assert(!JSON::number_extent_parser()("-x"sv));
+  constexpr auto partial = JSON::number_extent_parser()("1.e5"sv);
+  static_assert(partial && partial->first == "1"sv);
+}
+
+void document_tests()
+{
+#if CX_CONSTEXPR_ALLOCATION
+  // a document can be edited: only the children of containers that grow
+  // are moved
+  constexpr bool edited = [] {
+    JSON::document doc{R"({"a": [1, 2], "b": {"c": "x"}, "d": null})"};
+    const auto c = doc.root()["b"]["c"].index;
+
+    const auto e = doc.push_back(doc.root()["a"].index, R"({"e": "long string"})");
+    doc.insert(0, "f", "[true]");
+    doc.insert(doc.root()["a"].index, 0, "0");
+    const bool erased = doc.erase(0, "d") && !doc.erase(0, "d");
+    doc.replace(doc.root()["f"][0].index, "false");
+    doc.insert(e, "e", R"("short")");
+
+    const auto& root = doc.root();
+    return erased && root.object_Size() == 3
+      && root["a"].array_Size() == 4
+      && root["a"][0].to_Number() == 0 && root["a"][2].to_Number() == 2
+      && root["a"][3]["e"].to_String() == "short"
+      && !root["f"][0].to_Boolean()
+      && root["b"]["c"].index == c
+      && root["b"]["c"].to_String() == "x";
+  }();
+  static_assert(edited, "document edits");
+
+  // compacting drops the garbage left by edits
+  constexpr bool compacted = [] {
+    JSON::value_wrapper<6, 3> w;
+    w.construct(R"({"ab": [1], "c": 2})");
+    JSON::document doc{w};
+    doc.insert(0, "c", R"("de")");
+    doc.push_back(doc.root()["ab"].index, "[3]");
+    doc.erase(0, "ab");
+    const bool grown = doc.num_objects() > 3 && doc.string_size() > 3;
+    doc.compact();
+    return grown && doc.num_objects() == 3 && doc.string_size() == 3
+      && doc.root()["c"].to_String() == "de";
+  }();
+  static_assert(compacted, "document compaction");
+#endif
+}
+
+void image_tests()
+{
+#if CX_HAS_BIT_CAST
+  // a document round-trips through its flat image
+  {
+    constexpr bool ok = [] () {
+        JSON::value_wrapper<13, 9> jsv;
+        jsv.construct(R"({"a":1, "b":[true, null, "hello", ""], "c":{"d":2.5}})");
+        const auto img = JSON::make_image(jsv);
+        const JSON::image_view view{img.data(), img.size()};
+        const auto root = view.root();
+        return root.object_Size() == 3
+          && root["a"].to_Number() == 1
+          && root["b"].array_Size() == 4
+          && root["b"][0].to_Boolean()
+          && root["b"][1].is_Null()
+          && root["b"][2].to_String() == "hello"
+          && root["b"][3].string_Size() == 0
+          && root["c"]["d"].to_Number() == 2.5;
+    }();
+    static_assert(ok, "image round trip fail");
+  }
+#endif
+}
+
+// The mmap loader: an image written to a file, mapped and read back, and
+// truncated copies of it, which must be rejected.
+bool image_runtime_tests()
+{
+  bool ok = true;
+#if CX_HAS_BIT_CAST && CX_JSON_HAS_MMAP
+  const auto check = [&ok] (bool b, const char* what) {
+    if (!b) {
+      std::cerr << what << " fail\n";
+      ok = false;
+    }
+  };
+
+  JSON::value_wrapper<15, 16> jsv;
+  jsv.construct(R"({"a": -12, "b": [true, null, "héllo", ""],
+                    "c": {"d": 2.5, "e": 18446744073709551615}})"sv);
+  const auto img = JSON::make_image(jsv);
+
+  char path[] = "/tmp/cx_json_image_XXXXXX";
+  const int fd = ::mkstemp(path);
+  if (fd < 0) {
+    std::cerr << "image: cannot create a temporary file\n";
+    return false;
+  }
+  ::close(fd);
+  const auto write_file = [&path, &img] (std::size_t size) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(img.data(), static_cast<std::streamsize>(size));
+    return bool(out);
+  };
+  const auto rejected = [&path] {
+    try {
+      JSON::mapped_image m{path};
+    } catch (const std::runtime_error&) {
+      return true;
+    }
+    return false;
+  };
+
+  if (write_file(img.size())) {
+    const JSON::mapped_image m{path};
+    const auto root = m.root();
+    check(root.object_Size() == 3
+          && root["a"].to_Int64() == -12
+          && root["b"].array_Size() == 4
+          && root["b"][0].to_Boolean()
+          && root["b"][1].is_Null()
+          && root["b"][2].to_String() == "héllo"
+          && root["b"][3].string_Size() == 0
+          && root["c"]["d"].to_Number() == 2.5
+          && root["c"]["e"].to_UInt64() == 18446744073709551615u,
+          "mapped_image");
+  } else {
+    check(false, "image write");
+  }
+
+  // cut short in the header, the nodes and the strings
+  const auto nodes_end = JSON::image_header_size
+    + JSON::image_node_size * JSON::detail::read_u64(img.data() + 16);
+  const auto strings_end = nodes_end + JSON::detail::read_u64(img.data() + 24);
+  for (const std::size_t size : {std::size_t{0}, std::size_t{1}, JSON::image_header_size - 1,
+                                 JSON::image_header_size, nodes_end - 1, strings_end - 1}) {
+    check(write_file(size) && rejected(), "truncated image");
+  }
+
+  ::unlink(path);
+  check(rejected(), "missing image");
+#endif
+  return ok;
+}
+
+void cbor_tests()
+{
+#if CX_HAS_BIT_CAST
+  // {"a": 1, "b": [true, null, "hi"], "c": 2.5 (as a half float)}
+  constexpr auto doc = "\xa3\x61" "a" "\x01\x61" "b" "\x83\xf5\xf6\x62" "hi"
+                       "\x61" "c" "\xf9\x41\x00"sv;
+  static_assert(JSON::cbor_sizes(doc).num_objects == 10);
+  static_assert(JSON::cbor_sizes(doc).string_size == 5);
+
+  {
+    constexpr bool ok = [&] () {
+        JSON::value_wrapper<10, 5> jsv;
+        jsv.construct<JSON::cbor_recur>(doc);
+        return jsv.object_Size() == 3
+          && jsv["a"].to_Number() == 1
+          && jsv["b"][0].to_Boolean()
+          && jsv["b"][1].is_Null()
+          && jsv["b"][2].to_String() == "hi"
+          && jsv["c"].to_Number() == 2.5;
+    }();
+    static_assert(ok, "cbor decode fail");
+  }
+
+  {
+    // indefinite-length array and (chunked) string: [-2, "hell"]
+    constexpr bool ok = [] () {
+        JSON::value_wrapper<3, 4> jsv;
+        jsv.construct<JSON::cbor_recur>("\x9f\x21\x7f\x63" "hel" "\x61" "l" "\xff\xff"sv);
+        return jsv.array_Size() == 2
+          && jsv[0].to_Number() == -2
+          && jsv[1].to_String() == "hell";
+    }();
+    static_assert(ok, "cbor indefinite decode fail");
+  }
+
+  {
+    // integers decode exactly, and round-trip: [2^53 + 1, -2^63]
+    constexpr bool ok = [] () {
+        constexpr auto cbor = "\x82\x1b\x00\x20\x00\x00\x00\x00\x00\x01"
+                              "\x3b\x7f\xff\xff\xff\xff\xff\xff\xff"sv;
+        JSON::value_wrapper<3, 0> jsv;
+        jsv.construct<JSON::cbor_recur>(cbor);
+        std::array<char, 32> buf{};
+        const auto end = JSON::write_cbor(jsv, buf.begin());
+        return jsv[0].to_Int64() == 9007199254740993
+          && jsv[1].to_Int64() == std::numeric_limits<std::int64_t>::min()
+          && std::string_view(buf.data(), static_cast<std::size_t>(end - buf.begin())) == cbor;
+    }();
+    static_assert(ok, "cbor integer decode fail");
+  }
+
+  {
+    // JSON text round-trips through CBOR
+    constexpr bool ok = [] () {
+        JSON::value_wrapper<10, 4> text;
+        text.construct(R"({"x": [0.5, 1e300, 3], "yz": false, "w": null})");
+        std::array<char, 64> buf{};
+        const auto end = JSON::write_cbor(text, buf.begin());
+        const std::string_view cbor(buf.data(), static_cast<std::size_t>(end - buf.begin()));
+        JSON::value_wrapper<10, 4> bin;
+        bin.construct<JSON::cbor_recur>(cbor);
+        return bin["x"][0].to_Number() == 0.5
+          && bin["x"][1].to_Number() == text["x"][1].to_Number()
+          && bin["x"][2].to_Number() == 3
+          && !bin["yz"].to_Boolean()
+          && bin["w"].is_Null()
+          // 3 is written as an integer, 0.5 as a single and 1e300 as a double
+          && cbor.size() == 1 + 2 + 1 + 5 + 9 + 1 + 3 + 1 + 2 + 1;
+    }();
+    static_assert(ok, "cbor round trip fail");
+  }
+#endif
+}
+
+void fixed_string_tests()
+{
+  static constexpr cx::fixed_string s{"[1, \"ab\"]"};
+  static_assert(s.size() == 9 && s.view() == "[1, \"ab\"]"sv);
+  static_assert(JSON::sizes(s.view()).num_objects == 3);
+  static_assert(JSON::sizes(s.view()).string_size == 2);
+}
+
+void storage_view_tests()
+{
+  // the grammar parses into any storage, through views that erase its size
+  constexpr bool ok = [] {
+    JSON::value objects[4]{};
+    char strings[3]{};
+    JSON::object_storage_view ov{objects, 4};
+    JSON::string_storage_view sv{strings, 0, 3};
+    const auto r = JSON::storage_recur<>::value_parser(ov, sv, 0, 1)(R"([true, "ab", 1])"sv);
+    return r && r->first == 4 && sv.size() == 2
+      && objects[0].to_Array().extent == 3 && objects[1].to_Boolean()
+      && objects[2].to_String().extent == 2 && strings[1] == 'b'
+      && objects[3].to_Number() == 1;
+  }();
+  static_assert(ok, "storage_recur parses into views");
+
+  constexpr bool resized = [] {
+    cx::basic_string<char, 8> s{"ab"sv};
+    s.resize_and_overwrite(8, [] (char* p, std::size_t) { p[2] = 'c'; return std::size_t{3}; });
+    return s.size() == 3 && s[2] == 'c' && s[0] == 'a';
+  }();
+  static_assert(resized, "resize_and_overwrite keeps and extends the contents");
+}
+
+void utf8_tests()
+{
+  static_assert(cx::is_utf8("a\u00e9\u20ac\U0001F600"sv));
+  static_assert(!cx::is_utf8("\xC3"sv));           // truncated
+  static_assert(!cx::is_utf8("\xC0\xAF"sv));       // overlong
+  static_assert(!cx::is_utf8("\xED\xA0\x80"sv));   // surrogate
+  static_assert(!cx::is_utf8("\xF4\x90\x80\x80"sv)); // past U+10FFFF
+
+  // with ValidateUtf8, a string that isn't UTF-8 doesn't parse
+  constexpr auto parse = [] (std::string_view text, std::string_view expected) {
+    JSON::value objects[1]{};
+    char strings[16]{};
+    JSON::object_storage_view ov{objects, 1};
+    JSON::string_storage_view sv{strings, 0, 16};
+    const auto r = JSON::storage_recur<false, true>::value_parser(ov, sv, 0, 1)(text);
+    return r && objects[0].to_String().offset == 0
+      && std::string_view(strings, sv.size()) == expected;
+  };
+  static_assert(parse("\"\u00e9\\n\u20ac\\u0041\U0001F600\""sv,
+                      "\u00e9\n\u20acA\U0001F600"sv));
+  static_assert(parse("\"\""sv, ""sv));
+  static_assert(!parse("\"\xC3\""sv, ""sv));
+  static_assert(!parse("\"a\xC0\xAF\""sv, ""sv));
+  static_assert(!parse("\"\xED\xA0\x80\""sv, ""sv));
+
+  constexpr auto utf8 = [] {
+    JSON::value_wrapper<3, 8> w{};
+    w.construct<JSON::utf8_value_recur>("[\"\u00e9\", \"\U0001F600\"]"sv);
+    return w;
+  }();
+  static_assert(utf8[1].to_String() == "\U0001F600");
+}
+
+// The runtime paths of UTF-8 validation (SSSE3 where the CPU has it) and of
+// copying string runs (SSE2), which work a 16-byte block at a time: each
+// sequence is tried at every offset across two block boundaries, with and
+// without text after it (so that it may be truncated at a block end).
+bool utf8_runtime_tests()
+{
+  struct sequence { std::string_view bytes; bool valid; };
+  static constexpr sequence sequences[] = {
+    {"\xC3\xA9"sv, true},           // U+00E9
+    {"\xE2\x82\xAC"sv, true},       // U+20AC
+    {"\xF0\x9F\x98\x80"sv, true},   // U+1F600
+    {"\xF4\x8F\xBF\xBF"sv, true},   // U+10FFFF
+    {"\xEF\xBF\xBD"sv, true},       // U+FFFD
+    {"\xC3"sv, false},              // truncated
+    {"\xE2\x82"sv, false},
+    {"\xF0\x9F\x98"sv, false},
+    {"\x80"sv, false},              // a stray continuation
+    {"\xC0\xAF"sv, false},          // overlong
+    {"\xE0\x80\xAF"sv, false},
+    {"\xF0\x80\x80\xAF"sv, false},
+    {"\xED\xA0\x80"sv, false},      // surrogate
+    {"\xED\xBF\xBF"sv, false},
+    {"\xF4\x90\x80\x80"sv, false},  // past U+10FFFF
+    {"\xF5\x80\x80\x80"sv, false},
+    {"\xFF"sv, false},
+  };
+
+  bool ok = true;
+  const auto check = [&ok] (bool b, const char* what, std::size_t seq, std::size_t off) {
+    if (!b) {
+      std::cerr << what << " fail (sequence " << seq << ", offset " << off << ")\n";
+      ok = false;
+    }
+  };
+
+  for (std::size_t n = 0; n < std::size(sequences); ++n) {
+    const auto& seq = sequences[n];
+    for (std::size_t off = 0; off <= 40; ++off) {
+      for (const auto tail : {""sv, "tail of the string"sv}) {
+        const auto text = std::string(off, 'a') + std::string(seq.bytes) + std::string(tail);
+        check(cx::is_utf8(text) == seq.valid, "is_utf8", n, off);
+
+        const auto json = "\"" + text + "\"";
+        JSON::value objects[1]{};
+        char strings[128]{};
+        {
+          JSON::object_storage_view ov{objects, 1};
+          JSON::string_storage_view sv{strings, 0, 128};
+          const auto r = JSON::storage_recur<false, true>::value_parser(ov, sv, 0, 1)(json);
+          check(bool(r) == seq.valid, "utf8 storage_recur", n, off);
+          check(!r || std::string_view(strings, sv.size()) == text, "utf8 copy", n, off);
+        }
+        {
+          // without validation, the same bytes are copied whatever they are
+          JSON::object_storage_view ov{objects, 1};
+          JSON::string_storage_view sv{strings, 0, 128};
+          const auto r = JSON::storage_recur<>::value_parser(ov, sv, 0, 1)(json);
+          check(r && std::string_view(strings, sv.size()) == text, "copy", n, off);
+        }
+        if (seq.valid) {
+          JSON::value_wrapper<1, 128> w{};
+          w.construct<JSON::utf8_value_recur>(json);
+          check(w.to_String() == cx::static_string(text.data(), text.size()), "utf8_value_recur", n, off);
+        }
+      }
+    }
+  }
+  return ok;
+}
+
+void schema_tests()
+{
+  using namespace JSON::literals;
+
+  constexpr auto schema = R"({
+    "$schema": "http://json-schema.org/draft-07/schema#",
+    "type": "object",
+    "required": ["id", "kind"],
+    "additionalProperties": false,
+    "properties": {
+      "id": {"type": "integer", "minimum": 0},
+      "kind": {"enum": ["user", "group", null]},
+      "score": {"type": "number", "exclusiveMinimum": 0, "maximum": 1},
+      "name": {"type": "string", "minLength": 1, "maxLength": 4},
+      "tags": {"type": "array", "maxItems": 2, "items": {"type": "string"}},
+      "extra": {}
+    }
+  })"_json;
+  constexpr auto validate = JSON::make_schema_validator(schema);
+  static_assert(validate.num_nodes() == 8);
+
+  static_assert(validate(R"({"id": 3, "kind": "user"})"sv));
+  static_assert(validate(R"( {"kind": null, "id": 0, "score": 0.5,
+                              "name": "\u00e9t\u00e9", "tags": ["a", "b"],
+                              "extra": {"anything": [1, {"x": []}]}} )"sv));
+  static_assert(validate(R"({"id": 3, "kind": "gro\u0075p"})"sv));
+
+  // required keys
+  static_assert(!validate(R"({"id": 3})"sv));
+  // types and ranges
+  static_assert(!validate(R"({"id": 3.5, "kind": "user"})"sv));
+  static_assert(!validate(R"({"id": -1, "kind": "user"})"sv));
+  static_assert(!validate(R"({"id": "3", "kind": "user"})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "score": 0})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "score": 1.5})"sv));
+  // enums
+  static_assert(!validate(R"({"id": 3, "kind": "users"})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": true})"sv));
+  // lengths
+  static_assert(!validate(R"({"id": 3, "kind": "user", "name": ""})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "name": "abcde"})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "tags": ["a", "b", "c"]})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "tags": [1]})"sv));
+  // additional properties
+  static_assert(!validate(R"({"id": 3, "kind": "user", "other": 1})"sv));
+  // malformed input, even where the schema allows anything
+  static_assert(!validate(R"({"id": 3, "kind": "user")"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user", "extra": [1,})"sv));
+  static_assert(!validate(R"({"id": 3, "kind": "user"} x)"sv));
+
+  {
+    constexpr auto v = JSON::make_schema_validator(R"({"type": ["string", "null"]})"_json);
+    static_assert(v(R"("a")"sv) && v("null"sv) && !v("1"sv) && !v("[]"sv));
+  }
+  {
+    constexpr auto v = JSON::make_schema_validator("{}"_json);
+    static_assert(v("[1, true, {}]"sv) && !v("[1, true, {}"sv));
+  }
+
+  // a key that is only required is still an additional property
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"required": ["a"], "additionalProperties": false})"_json);
+    static_assert(!v(R"({"a": 1})"sv) && !v("{}"sv));
+  }
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"required": ["a"], "properties": {"b": {}}})"_json);
+    static_assert(v(R"({"a": 1, "b": 2})"sv) && !v(R"({"b": 2})"sv));
+  }
+
+  // minimum and exclusiveMinimum both apply, whichever comes first
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"exclusiveMinimum": 5, "minimum": 3})"_json);
+    static_assert(!v("4"sv) && !v("5"sv) && v("5.5"sv));
+  }
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"minimum": 3, "exclusiveMinimum": 1})"_json);
+    static_assert(!v("2"sv) && v("3"sv));
+  }
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"maximum": 7, "exclusiveMaximum": 9})"_json);
+    static_assert(!v("8"sv) && v("7"sv));
+  }
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"exclusiveMaximum": 5, "maximum": 9})"_json);
+    static_assert(!v("5"sv) && v("4"sv));
+  }
+  // draft 4: a boolean exclusiveMinimum/exclusiveMaximum modifies
+  // minimum/maximum
+  {
+    constexpr auto v = JSON::make_schema_validator(
+        R"({"exclusiveMinimum": true, "minimum": 3, "maximum": 5,
+            "exclusiveMaximum": true})"_json);
+    static_assert(!v("3"sv) && v("4"sv) && !v("5"sv));
+  }
+}
+
 void fail_tests()
 {
   // intentionally failing parse tests
@@ -1,6 +1,24 @@
+#include <iostream>
+
 void object_value_tests();
 
+// The tests are static_asserts, except for the runtime code paths (which
+// constant evaluation never takes): those tests report what fails, and
+// return whether everything passed.
+bool algo_runtime_tests_simd();
+bool algo_runtime_tests_execution();
+bool utf8_runtime_tests();
+bool image_runtime_tests();
+
 int main(void)
 {
   object_value_tests();
+
+  bool ok = true;
+  ok = algo_runtime_tests_simd() && ok;
+  ok = algo_runtime_tests_execution() && ok;
+  ok = utf8_runtime_tests() && ok;
+  ok = image_runtime_tests() && ok;
+  if (!ok) std::cerr << "runtime tests failed\n";
+  return ok ? 0 : 1;
 }
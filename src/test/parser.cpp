@@ -0,0 +1,209 @@
+#include <cx_parser.h>
+#include <cx_string.h>
+
+#include <string_view>
+#include <type_traits>
+
+using namespace std::literals;
+
+void optional_tests()
+{
+  using namespace cx::parser;
+
+  // results need not be default-constructible: a failed parse never
+  // constructs one
+  struct digit
+  {
+    constexpr explicit digit(char c) : value(c - '0') {}
+    int value;
+  };
+
+  constexpr auto p = fmap([] (char c) { return digit{c}; },
+                          one_of("0123456789"sv));
+  {
+    constexpr auto r = p("7"sv);
+    static_assert(r && r->first.value == 7);
+  }
+  {
+    constexpr auto r = p("x"sv);
+    static_assert(!r);
+  }
+  {
+    constexpr cx::optional<digit> o = std::nullopt;
+    static_assert(!o.has_value());
+  }
+}
+
+void memo_tests()
+{
+  using namespace cx::parser;
+
+  {
+    // a memoized parser gives the same results as the parser itself
+    constexpr auto r = [] {
+      memo_table<char> t;
+      return memo(make_char_parser('a'), t)("ab"sv);
+    }();
+    static_assert(r && r->first == 'a' && r->second.size() == 1);
+
+    constexpr auto f = [] {
+      memo_table<char> t;
+      return memo(make_char_parser('a'), t)("ba"sv);
+    }();
+    static_assert(!f);
+  }
+
+  {
+    // and runs only once per position, however many times alternation
+    // backtracks over it
+    constexpr auto calls = [] {
+      int n = 0;
+      const auto counted = [&n] (parse_input_t s) {
+        ++n;
+        return make_char_parser('a')(s);
+      };
+      memo_table<char> t;
+      const auto a = memo(counted, t);
+      const auto p = (a < make_char_parser('b'))
+        | (a < make_char_parser('c'))
+        | (a < make_char_parser('d'));
+      const auto r = p("ad"sv);
+      return r && r->first == 'd' ? n : -1;
+    }();
+    static_assert(calls == 1);
+  }
+
+  {
+    // once cleared, the table forgets what it saw
+    constexpr auto calls = [] {
+      int n = 0;
+      const auto counted = [&n] (parse_input_t s) {
+        ++n;
+        return make_char_parser('a')(s);
+      };
+      memo_table<char, 4> t;
+      const auto a = memo(counted, t);
+      a("a"sv);
+      a("a"sv);
+      t.clear();
+      a("a"sv);
+      return n;
+    }();
+    static_assert(calls == 2);
+  }
+}
+
+void dispatch_tests()
+{
+  using namespace cx::parser;
+
+  constexpr auto p = dispatch(
+      arm("ab"sv, make_string_parser("abc"sv)),
+      arm("x"sv, make_string_parser("xyz"sv)),
+      arm("a"sv, make_string_parser("aaa"sv)));
+
+  {
+    // the first char picks the arm
+    constexpr auto r = p("xyz!"sv);
+    static_assert(r && r->first == "xyz"sv && r->second == "!"sv);
+  }
+  {
+    // earlier arms win where the char sets overlap, and only the chosen arm
+    // is tried
+    constexpr auto r1 = p("abc"sv);
+    static_assert(r1 && r1->first == "abc"sv);
+    constexpr auto r2 = p("aaa"sv);
+    static_assert(!r2);
+  }
+  {
+    // chars without an arm (and empty input) fail
+    static_assert(!p("zzz"sv));
+    static_assert(!p(""sv));
+  }
+}
+
+void accumulate_tests()
+{
+  using namespace cx::parser;
+  using S = cx::basic_string<char, 8>;
+
+  // accumulating functions may update the accumulator in place rather than
+  // returning a new one
+  constexpr auto push = [] (S& acc, char c) { acc.push_back(c); };
+
+  {
+    constexpr auto r = many(one_of("abc"sv), S{}, push)("abcx"sv);
+    static_assert(r && r->first == "abc" && r->second == "x"sv);
+  }
+  {
+    constexpr auto p = many1(one_of("abc"sv), S{}, push);
+    constexpr auto r = p("cab"sv);
+    static_assert(r && r->first == "cab" && r->second.empty());
+    static_assert(!p("xyz"sv));
+  }
+  {
+    constexpr auto r = separated_by_val(one_of("abc"sv), make_char_parser(','),
+                                        S{}, push)("a,b,c"sv);
+    static_assert(r && r->first == "abc" && r->second.empty());
+  }
+  {
+    // and value-returning accumulators still work as before
+    constexpr auto r = exactly_n(one_of("0123456789"sv), 3, 0,
+                                 [] (int acc, char c) { return acc*10 + (c-'0'); })("1234"sv);
+    static_assert(r && r->first == 123 && r->second == "4"sv);
+  }
+}
+
+void rope_tests()
+{
+  using namespace cx::parser;
+
+  // segmented input parses as though it were concatenated: tokens may
+  // straddle segments, and empty segments are skipped
+  static constexpr std::string_view segments[] = {"12,3"sv, ""sv, "4,5"sv, "67 end"sv};
+
+  {
+    constexpr auto r = separated_by_val(int0_parser(), make_char_parser(','), 0,
+                                        [] (int acc, int n) { return acc + n; })(
+                                          rope_input(segments));
+    static_assert(r && r->first == 12 + 34 + 567);
+    static_assert(r->second.size() == 4 && r->second.front() == ' ');
+    static_assert(r->second.chunk() == " end"sv);
+  }
+  {
+    constexpr auto p = skip_whitespace() < make_string_parser("end"sv);
+    constexpr auto r = p(drop(rope_input(segments), 9));
+    static_assert(r && r->first == "end"sv && r->second.empty());
+    static_assert(!p(drop(rope_input(segments), 8)));
+  }
+  {
+    static constexpr std::string_view split[] = {"tr"sv, "u"sv, "e!"sv};
+    constexpr auto p = dispatch(arm("t"sv, make_string_parser("true"sv)),
+                                arm("f"sv, make_string_parser("false"sv)));
+    constexpr auto r = p(rope_input(split));
+    static_assert(r && r->first == "true"sv && r->second.chunk() == "!"sv);
+    static_assert(!make_string_parser("trues"sv)(rope_input(split)));
+  }
+  {
+    // while anything that converts to a string_view is parsed as one
+    constexpr auto r = many(one_of("ab"sv), 0, [] (int n, char) { return n + 1; })("abc");
+    static_assert(std::is_same_v<decltype(r->second), std::string_view>);
+    static_assert(r && r->first == 2 && r->second == "c"sv);
+  }
+  {
+    // memo keys on the position within the rope
+    constexpr auto calls = [] {
+      int n = 0;
+      const auto counted = [&n] (auto s) {
+        ++n;
+        return int0_parser()(s);
+      };
+      memo_table<int, 16, rope_input> t;
+      const auto a = memo(counted, t);
+      const auto p = (a < make_char_parser('!')) | (a < make_char_parser(','));
+      const auto r = p(rope_input(segments));
+      return r && r->first == ',' ? n : -1;
+    }();
+    static_assert(calls == 1);
+  }
+}
@@ -0,0 +1,163 @@
+// Compile a JSON file into a header of constexpr storage, for cx_embed_json()
+// in cmake/CxEmbedJson.cmake:
+//
+//   cx_embed_json <input.json> <output.h> <namespace>
+//
+// The header defines, in the given namespace, the parsed value storage
+// (objects), the string storage (strings) and a value_proxy over them (json),
+// so that consumers get the usual interface with no parsing at all - not even
+// at compile time.
+
+#include <cx_json_parser.h>
+#include <cx_json_value.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+  std::string external(const char* type, const JSON::value::ExternalView& ev)
+  {
+    return std::string("{JSON::value::Type::") + type + ", JSON::value::ExternalView{"
+      + std::to_string(ev.offset) + ", " + std::to_string(ev.extent) + "}}";
+  }
+
+  std::string node(const JSON::value& v)
+  {
+    switch (v.type) {
+      case JSON::value::Type::String: {
+        // an empty string's offset is irrelevant, so emit it as 0
+        const auto& ev = v.to_String();
+        return external("String", ev.extent == 0 ? JSON::value::ExternalView{0, 0} : ev);
+      }
+      case JSON::value::Type::Array: return external("Array", v.to_Array());
+      case JSON::value::Type::Object: return external("Object", v.to_Object());
+      case JSON::value::Type::Boolean:
+        return v.to_Boolean() ? "{JSON::value::Type::Boolean, true}"
+                              : "{JSON::value::Type::Boolean, false}";
+      case JSON::value::Type::Number: {
+        // numbers too large for a double parse as infinities
+        if (std::isinf(v.to_Number())) {
+          return std::string("{JSON::value::Type::Number, ")
+            + (v.to_Number() < 0 ? "-" : "")
+            + "std::numeric_limits<double>::infinity()}";
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof buf, "%.17g", v.to_Number());
+        std::string d = buf;
+        // a double literal, so that it doesn't convert ambiguously
+        if (d.find_first_of(".e") == std::string::npos) d += ".0";
+        return "{JSON::value::Type::Number, " + d + "}";
+      }
+      case JSON::value::Type::Integer: {
+        const auto i = v.to_Int64();
+        // -2^63 can't be written as a literal
+        const auto lit = i == std::numeric_limits<std::int64_t>::min()
+          ? std::to_string(i + 1) + " - 1" : std::to_string(i);
+        return "{JSON::value::Type::Integer, std::int64_t{" + lit + "}}";
+      }
+      case JSON::value::Type::Unsigned:
+        return "{JSON::value::Type::Unsigned, std::uint64_t{"
+          + std::to_string(v.to_UInt64()) + "u}}";
+      case JSON::value::Type::RawNumber: return node(v.decode_number());
+      case JSON::value::Type::Null: return "{}";
+      case JSON::value::Type::Unparsed:
+      default:
+        throw std::runtime_error("unparsed value");
+    }
+  }
+
+  // a string literal, with everything but printable ASCII as octal escapes
+  void write_string_literal(std::ostream& out, std::string_view s)
+  {
+    constexpr std::size_t line_length = 64;
+    out << "  \"";
+    for (std::size_t i = 0; i < s.size(); ++i) {
+      if (i != 0 && i % line_length == 0) out << "\"\n  \"";
+      const auto c = static_cast<unsigned char>(s[i]);
+      if (c == '"' || c == '\\') {
+        out << '\\' << s[i];
+      } else if (c >= 0x20 && c < 0x7f) {
+        out << s[i];
+      } else {
+        char buf[8];
+        std::snprintf(buf, sizeof buf, "\\%03o", static_cast<unsigned>(c));
+        out << buf;
+      }
+    }
+    out << "\"";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4) {
+    std::cerr << "usage: cx_embed_json <input.json> <output.h> <namespace>\n";
+    return 2;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::cerr << argv[1] << ": cannot read\n";
+    return 1;
+  }
+  const std::string contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  const std::string_view text = contents;
+
+  try {
+    const auto sizes = JSON::sizes_parser()(text);
+    if (!sizes) throw std::runtime_error("not valid JSON");
+
+    // storage of exactly the size the document needs
+    std::vector<JSON::value> objects(sizes->first.num_objects);
+    std::string strings(sizes->first.string_size, '\0');
+    JSON::object_storage_view objects_view{objects.data(), objects.size()};
+    JSON::string_storage_view strings_view{strings.data(), 0, strings.size()};
+    const auto r = JSON::storage_recur<>::value_parser(objects_view, strings_view, 0, 1)(text);
+    if (!r) throw std::runtime_error("not valid JSON");
+    const auto rest = JSON::skip_whitespace()(r->second);
+    if (rest && !rest->second.empty()) throw std::runtime_error("trailing characters");
+    const auto num_objects = r->first;
+
+    std::ostringstream out;
+    out << "// Generated by cx_embed_json from " << argv[1] << " - do not edit.\n\n"
+        << "#pragma once\n\n"
+        << "#include <cx_json_value.h>\n\n"
+        << "#include <cstdint>\n"
+        << "#include <limits>\n\n"
+        << "namespace " << argv[3] << "\n{\n"
+        << "  inline constexpr JSON::value objects[] = {\n";
+    for (std::size_t i = 0; i < num_objects; ++i) {
+      out << "    JSON::value" << node(objects[i]) << ",\n";
+    }
+    out << "  };\n\n"
+        << "  inline constexpr char strings[] =\n";
+    write_string_literal(out, std::string_view(strings.data(), strings_view.size()));
+    out << ";\n\n"
+        << "  inline constexpr JSON::value_proxy json{0, objects, strings};\n"
+        << "}\n";
+
+    std::ofstream header(argv[2], std::ios::binary);
+    header << out.str();
+    if (!header) {
+      std::cerr << argv[2] << ": cannot write\n";
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << argv[1] << ": " << e.what() << "\n";
+    return 1;
+  } catch (const char* e) {
+    std::cerr << argv[1] << ": " << e << "\n";
+    return 1;
+  }
+}